@@ -1,5 +1,5 @@
 import { ParserOptions } from '../src/options'
-import { baseParse, TextModes } from '../src/parse'
+import { baseParse, baseReparse, TextModes } from '../src/parse'
 import { ErrorCodes } from '../src/errors'
 import {
   CommentNode,
@@ -2116,6 +2116,92 @@ foo
     })
   })
 
+  describe('incremental reparse', () => {
+    function edit(source: string, search: string, text: string) {
+      const start = source.indexOf(search)
+      return {
+        edit: { start, end: start + search.length, text },
+        source:
+          source.slice(0, start) + text + source.slice(start + search.length)
+      }
+    }
+
+    test('re-parses only the smallest enclosing element', () => {
+      const source = `<div id="a">\n  <p>{{ foo }}</p>\n  <span>bar</span>\n</div>\n<i/>`
+      const ast = baseParse(source)
+      const div = ast.children[0] as ElementNode
+      const [p, span] = div.children
+      const i = ast.children[1]
+
+      const { edit: e, source: newSource } = edit(source, 'foo', 'bar\n+ baz')
+      const result = baseReparse(ast, e)
+
+      expect(result).toBe(ast)
+      expect(result).toStrictEqual(baseParse(newSource))
+      // the edited element is replaced, everything else is reused
+      expect(div.children[0]).not.toBe(p)
+      expect(div.children[1]).toBe(span)
+      expect(ast.children[0]).toBe(div)
+      expect(ast.children[1]).toBe(i)
+      // and shifted
+      expect(span.loc.start).toEqual({ offset: 40, line: 4, column: 3 })
+      expect(i.loc.start).toEqual({ offset: 64, line: 6, column: 1 })
+    })
+
+    test('attribute edits', () => {
+      const source = `<div><input :value="a" @input="b"/><p>c</p></div>`
+      const ast = baseParse(source)
+      const { edit: e, source: newSource } = edit(source, '"b"', '"onInput"')
+      expect(baseReparse(ast, e)).toStrictEqual(baseParse(newSource))
+    })
+
+    test('widens the re-parsed range when the structure changes', () => {
+      const source = `<div><section><p>foo</p></section><p>bar</p></div>`
+      const ast = baseParse(source)
+      const section = (ast.children[0] as ElementNode).children[0]
+      // closing the <p> early changes the shape of its parent
+      const { edit: e, source: newSource } = edit(source, 'foo', 'foo</p><p>')
+      const result = baseReparse(ast, e)
+      expect(result).toBe(ast)
+      expect(result).toStrictEqual(baseParse(newSource))
+      expect((ast.children[0] as ElementNode).children[0]).not.toBe(section)
+    })
+
+    test('falls back to a full parse for top-level changes', () => {
+      const source = `<div>foo</div><p>bar</p>`
+      const ast = baseParse(source)
+      const { edit: e, source: newSource } = edit(source, '</div>', '')
+      const div = ast.children[0]
+      const result = baseReparse(ast, e, { onError: () => {} })
+      // still updated in place
+      expect(result).toBe(ast)
+      expect(result).toStrictEqual(baseParse(newSource, { onError: () => {} }))
+      expect(result.children[0]).not.toBe(div)
+    })
+
+    test('does not re-parse elements inside v-pre on their own', () => {
+      const source = `<div v-pre><p :a="b">{{ foo }}</p></div>`
+      const ast = baseParse(source)
+      const div = ast.children[0]
+      const { edit: e, source: newSource } = edit(source, 'foo', 'bar')
+      const result = baseReparse(ast, e)
+      expect(result).toStrictEqual(baseParse(newSource))
+      // the element carrying v-pre is re-parsed as a whole
+      expect(result.children[0]).not.toBe(div)
+    })
+
+    test('only reports errors of the successful attempt', () => {
+      const source = `<div><p><span>foo</span></p></div>`
+      const ast = baseParse(source)
+      const spy = jest.fn()
+      // unclosed <b> inside <span>: the span still ends where it did before
+      baseReparse(ast, edit(source, 'foo', '<b>foo').edit, { onError: spy })
+      expect(spy.mock.calls.map(([err]) => err.code)).toEqual([
+        ErrorCodes.X_MISSING_END_TAG
+      ])
+    })
+  })
+
   describe('Errors', () => {
     const patterns: {
       [key: string]: Array<{
@@ -10,7 +10,7 @@ export {
   BindingMetadata,
   BindingTypes
 } from './options'
-export { baseParse, TextModes } from './parse'
+export { baseParse, baseReparse, TemplateEdit, TextModes } from './parse'
 export {
   transform,
   TransformContext,
@@ -28,6 +28,7 @@ import {
   TextNode,
   TemplateChildNode,
   InterpolationNode,
+  ParentNode,
   createRoot,
   ConstantTypes
 } from './ast'
@@ -95,14 +96,16 @@ export const enum TextModes {
 // line：当前代码的行号
 // offset：当前代码相对原始代码的偏移量
 // originalSource：表示最初的原始代码
-// source：当前代码
 // inPre：代码是否在 pre 标签内
 // inVPre：代码是否在 v-pre 指令下
 // onWarn：warn 函数
+//
+// The parser never slices the remaining input off `originalSource`: all scans
+// are performed in place starting at `offset`, so the cost of advancing is
+// proportional to the consumed characters rather than the remaining template.
 export interface ParserContext {
   options: MergedParserOptions
   readonly originalSource: string
-  source: string
   offset: number
   line: number
   column: number
@@ -125,6 +128,260 @@ export function baseParse(
   )
 }
 
+/**
+ * A text edit applied to a previously parsed template: the `[start, end)`
+ * range (offsets into the previous source) is replaced with `text`.
+ */
+export interface TemplateEdit {
+  start: number
+  end: number
+  text: string
+}
+
+/**
+ * Re-parse a template after an edit, only re-parsing the smallest element
+ * that fully encloses the edited range. Untouched nodes are reused and nodes
+ * after the edit have their `loc` shifted. Falls back to enclosing elements
+ * and eventually a full `baseParse` whenever the edit changes the structure
+ * around the re-parsed element.
+ *
+ * `root` must be the untransformed output of `baseParse` (or a previous
+ * `baseReparse`) with the same options - the transform phase mutates the AST
+ * in place. The root is updated in place and returned.
+ */
+export function baseReparse(
+  root: RootNode,
+  edit: TemplateEdit,
+  options: ParserOptions = {}
+): RootNode {
+  const oldSource = root.loc.source
+  const { start, end, text } = edit
+  const source = oldSource.slice(0, start) + text + oldSource.slice(end)
+
+  // collect the elements enclosing the edit, outermost first
+  const chain: ElementNode[] = []
+  let children = root.children
+  let i = 0
+  while (i < children.length) {
+    const child = children[i++]
+    if (
+      child.type === NodeTypes.ELEMENT &&
+      child.loc.start.offset < start &&
+      child.loc.end.offset > end
+    ) {
+      chain.push(child)
+      children = child.children
+      i = 0
+    }
+  }
+
+  // try the innermost element first and widen the range on failure
+  for (let depth = chain.length - 1; depth >= 0; depth--) {
+    const ancestors = chain.slice(0, depth)
+    const oldElement = chain[depth]
+    const element = reparseElement(
+      root,
+      source,
+      oldSource,
+      oldElement,
+      ancestors,
+      text.length - (end - start),
+      options
+    )
+    if (element) {
+      const siblings = depth ? chain[depth - 1].children : root.children
+      siblings[siblings.indexOf(oldElement)] = element
+      shiftLocations(
+        root,
+        element,
+        source,
+        oldElement.loc.end,
+        element.loc.end,
+        new Set()
+      )
+      return root
+    }
+  }
+
+  // the fresh root replaces the content of the old one
+  return extend(root, baseParse(source, options))
+}
+
+function reparseElement(
+  root: RootNode,
+  source: string,
+  oldSource: string,
+  oldElement: ElementNode,
+  ancestors: ElementNode[],
+  delta: number,
+  rawOptions: ParserOptions
+): ElementNode | undefined {
+  // v-pre and 2.x inline-template leave no trace in the AST that would allow
+  // restoring the parser state or refreshing the ancestor, so bail out
+  for (let i = 0; i < ancestors.length; i++) {
+    const a = ancestors[i]
+    const tagEnd = a.children.length
+      ? a.children[0].loc.start.offset
+      : a.loc.end.offset
+    if (
+      oldSource.slice(a.loc.start.offset, tagEnd).includes('v-pre') ||
+      (__COMPAT__ && a.props.some(p => p.name === 'inline-template'))
+    ) {
+      return
+    }
+  }
+
+  const context = createParserContext(source, rawOptions)
+  const { options } = context
+  // buffer errors and warnings so that a failed attempt reports nothing
+  const { onError, onWarn } = options
+  const reports: (() => void)[] = []
+  options.onError = err => {
+    reports.push(() => onError(err))
+  }
+  context.onWarn = options.onWarn = warning => {
+    reports.push(() => onWarn(warning))
+  }
+  extend(context, oldElement.loc.start)
+  context.inPre = ancestors.some(a => options.isPreTag(a.tag))
+  // a stray end tag of a pre tag (e.g. `</pre>`) also switches the parser into
+  // pre mode for the rest of the template, bail if the old element or the
+  // source before it may contain one
+  if (
+    !context.inPre &&
+    countPreEndTags(oldSource, oldElement.loc.end.offset, options) >
+      countClosedPreElements(root, oldElement.loc.end.offset, options)
+  ) {
+    return
+  }
+  const wasInPre = context.inPre
+
+  if (!matchAt(context, /<[a-z]/iy)) {
+    return
+  }
+  const element = parseElement(context, ancestors)
+  if (
+    !element ||
+    // the element must end exactly where the old one did (shifted by the
+    // edit), otherwise the surrounding structure has changed
+    context.offset !== oldElement.loc.end.offset + delta ||
+    context.inPre !== wasInPre ||
+    // 2.x native <template> compat replaces the node with its children
+    (__COMPAT__ &&
+      element.tag === 'template' &&
+      element.tagType !== ElementTypes.TEMPLATE)
+  ) {
+    return
+  }
+
+  options.onError = onError
+  context.onWarn = options.onWarn = onWarn
+  reports.forEach(report => report())
+  return element
+}
+
+function countPreEndTags(
+  source: string,
+  end: number,
+  options: MergedParserOptions
+): number {
+  const endTagRE = /<\/([a-z][^\t\r\n\f />]*)/gi
+  let count = 0
+  let match: RegExpExecArray | null
+  while ((match = endTagRE.exec(source)) && match.index < end) {
+    if (options.isPreTag(match[1])) {
+      count++
+    }
+  }
+  return count
+}
+
+// pre elements ending before `end` that were closed by their own end tag
+function countClosedPreElements(
+  node: ParentNode,
+  end: number,
+  options: MergedParserOptions
+): number {
+  let count = 0
+  const { children } = node
+  for (let i = 0; i < children.length; i++) {
+    const child = children[i]
+    if (child.type !== NodeTypes.ELEMENT || child.loc.start.offset >= end) {
+      continue
+    }
+    count += countClosedPreElements(child, end, options)
+    const { tag, loc } = child
+    const tagStart = loc.source.lastIndexOf('</') + 2
+    if (
+      options.isPreTag(tag) &&
+      loc.end.offset <= end &&
+      tagStart > 1 &&
+      loc.source.slice(tagStart, tagStart + tag.length).toLowerCase() ===
+        tag.toLowerCase()
+    ) {
+      count++
+    }
+  }
+  return count
+}
+
+// Shift every position at or after `oldEnd` so that it lines up with
+// `newEnd`, and refresh the source of locations spanning the edit.
+function shiftLocations(
+  node: any,
+  skip: ElementNode,
+  source: string,
+  oldEnd: Position,
+  newEnd: Position,
+  seen: Set<Position>
+) {
+  const loc: SourceLocation = node.loc
+  if (node === skip || loc.end.offset < oldEnd.offset) {
+    return
+  }
+  const spansEdit = loc.start.offset < oldEnd.offset
+  shiftPosition(loc.start, oldEnd, newEnd, seen)
+  shiftPosition(loc.end, oldEnd, newEnd, seen)
+  if (spansEdit) {
+    loc.source = source.slice(loc.start.offset, loc.end.offset)
+  }
+
+  const { children, props, value, exp, arg, content } = node
+  if (children) {
+    for (let i = 0; i < children.length; i++) {
+      shiftLocations(children[i], skip, source, oldEnd, newEnd, seen)
+    }
+  }
+  if (props) {
+    for (let i = 0; i < props.length; i++) {
+      shiftLocations(props[i], skip, source, oldEnd, newEnd, seen)
+    }
+  }
+  for (const child of [value, exp, arg, content]) {
+    if (child && child.loc) {
+      shiftLocations(child, skip, source, oldEnd, newEnd, seen)
+    }
+  }
+}
+
+function shiftPosition(
+  pos: Position,
+  oldEnd: Position,
+  newEnd: Position,
+  seen: Set<Position>
+) {
+  // positions can be shared between locations, only shift them once
+  if (pos.offset < oldEnd.offset || seen.has(pos)) {
+    return
+  }
+  seen.add(pos)
+  if (pos.line === oldEnd.line) {
+    pos.column += newEnd.column - oldEnd.column
+  }
+  pos.line += newEnd.line - oldEnd.line
+  pos.offset += newEnd.offset - oldEnd.offset
+}
+
 // 创建解析上下文
 // 在后续的解析过程中，对上下文的信息进行更新，用来表示当前解析的状态。
 function createParserContext(
@@ -147,7 +404,6 @@ function createParserContext(
     line: 1,
     offset: 0,
     originalSource: content,
-    source: content,
     inPre: false,
     inVPre: false,
     onWarn: options.onWarn
@@ -166,26 +422,30 @@ function parseChildren(
   const nodes: TemplateChildNode[] = []
 
   while (!isEnd(context, mode, ancestors)) {
-    __TEST__ && assert(context.source.length > 0)
-    const s = context.source
+    __TEST__ && assert(remaining(context) > 0)
+    const s = context.originalSource
+    const i = context.offset
     let node: TemplateChildNode | TemplateChildNode[] | undefined = undefined
 
     if (mode === TextModes.DATA || mode === TextModes.RCDATA) {
-      if (!context.inVPre && startsWith(s, context.options.delimiters[0])) {
+      if (
+        !context.inVPre &&
+        startsWith(context, context.options.delimiters[0])
+      ) {
         // '{{'
         node = parseInterpolation(context, mode)
-      } else if (mode === TextModes.DATA && s[0] === '<') {
+      } else if (mode === TextModes.DATA && s[i] === '<') {
         // https://html.spec.whatwg.org/multipage/parsing.html#tag-open-state
-        if (s.length === 1) {
+        if (remaining(context) === 1) {
           emitError(context, ErrorCodes.EOF_BEFORE_TAG_NAME, 1)
-        } else if (s[1] === '!') {
+        } else if (s[i + 1] === '!') {
           // https://html.spec.whatwg.org/multipage/parsing.html#markup-declaration-open-state
-          if (startsWith(s, '<!--')) {
+          if (startsWith(context, '<!--')) {
             node = parseComment(context)
-          } else if (startsWith(s, '<!DOCTYPE')) {
+          } else if (startsWith(context, '<!DOCTYPE')) {
             // Ignore DOCTYPE by a limitation.
             node = parseBogusComment(context)
-          } else if (startsWith(s, '<![CDATA[')) {
+          } else if (startsWith(context, '<![CDATA[')) {
             if (ns !== Namespaces.HTML) {
               node = parseCDATA(context, ancestors)
             } else {
@@ -196,15 +456,15 @@ function parseChildren(
             emitError(context, ErrorCodes.INCORRECTLY_OPENED_COMMENT)
             node = parseBogusComment(context)
           }
-        } else if (s[1] === '/') {
+        } else if (s[i + 1] === '/') {
           // https://html.spec.whatwg.org/multipage/parsing.html#end-tag-open-state
-          if (s.length === 2) {
+          if (remaining(context) === 2) {
             emitError(context, ErrorCodes.EOF_BEFORE_TAG_NAME, 2)
-          } else if (s[2] === '>') {
+          } else if (s[i + 2] === '>') {
             emitError(context, ErrorCodes.MISSING_END_TAG_NAME, 2)
             advanceBy(context, 3)
             continue
-          } else if (/[a-z]/i.test(s[2])) {
+          } else if (/[a-z]/i.test(s[i + 2])) {
             emitError(context, ErrorCodes.X_INVALID_END_TAG)
             parseTag(context, TagType.End, parent)
             continue
@@ -216,7 +476,7 @@ function parseChildren(
             )
             node = parseBogusComment(context)
           }
-        } else if (/[a-z]/i.test(s[1])) {
+        } else if (/[a-z]/i.test(s[i + 1])) {
           //<开头 并且后面是字母
           node = parseElement(context, ancestors)
 
@@ -243,7 +503,7 @@ function parseChildren(
               )
             node = node.children
           }
-        } else if (s[1] === '?') {
+        } else if (s[i + 1] === '?') {
           emitError(
             context,
             ErrorCodes.UNEXPECTED_QUESTION_MARK_INSTEAD_OF_TAG_NAME,
@@ -366,14 +626,14 @@ function parseCDATA(
 ): TemplateChildNode[] {
   __TEST__ &&
     assert(last(ancestors) == null || last(ancestors)!.ns !== Namespaces.HTML)
-  __TEST__ && assert(startsWith(context.source, '<![CDATA['))
+  __TEST__ && assert(startsWith(context, '<![CDATA['))
 
   advanceBy(context, 9)
   const nodes = parseChildren(context, TextModes.CDATA, ancestors)
-  if (context.source.length === 0) {
+  if (remaining(context) === 0) {
     emitError(context, ErrorCodes.EOF_IN_CDATA)
   } else {
-    __TEST__ && assert(startsWith(context.source, ']]>'))
+    __TEST__ && assert(startsWith(context, ']]>'))
     advanceBy(context, 3)
   }
 
@@ -381,31 +641,36 @@ function parseCDATA(
 }
 // 解析注释
 function parseComment(context: ParserContext): CommentNode {
-  __TEST__ && assert(startsWith(context.source, '<!--'))
+  __TEST__ && assert(startsWith(context, '<!--'))
 
   const start = getCursor(context)
+  const source = context.originalSource
+  const offset = context.offset
   let content: string
 
   // Regular comment.
-  const match = /--(\!)?>/.exec(context.source)
+  commentEndRE.lastIndex = offset
+  const match = commentEndRE.exec(source)
   if (!match) {
     //没有匹配到或者注释结束符不合法，会报错
-    content = context.source.slice(4)
-    advanceBy(context, context.source.length)
+    content = source.slice(offset + 4)
+    advanceBy(context, remaining(context))
     emitError(context, ErrorCodes.EOF_IN_COMMENT)
   } else {
-    if (match.index <= 3) {
+    // index of the comment end relative to the current offset
+    const endIndex = match.index - offset
+    if (endIndex <= 3) {
       emitError(context, ErrorCodes.ABRUPT_CLOSING_OF_EMPTY_COMMENT)
     }
     if (match[1]) {
       emitError(context, ErrorCodes.INCORRECTLY_CLOSED_COMMENT)
     }
     // 获取中间的注释内容 content
-    content = context.source.slice(4, match.index)
+    content = source.slice(offset + 4, match.index)
 
     // Advancing with reporting nested comments.
     //有嵌套注释也会报错
-    const s = context.source.slice(0, match.index)
+    const s = source.slice(offset, match.index)
     let prevIndex = 1,
       nestedIndex = 0
     while ((nestedIndex = s.indexOf('<!--', prevIndex)) !== -1) {
@@ -415,7 +680,7 @@ function parseComment(context: ParserContext): CommentNode {
       }
       prevIndex = nestedIndex + 1
     }
-    advanceBy(context, match.index + match[0].length - prevIndex + 1)
+    advanceBy(context, endIndex + match[0].length - prevIndex + 1)
   }
   //描述注释节点的对象
   return {
@@ -426,19 +691,21 @@ function parseComment(context: ParserContext): CommentNode {
 }
 //<!DOCTYPE 节点解析
 function parseBogusComment(context: ParserContext): CommentNode | undefined {
-  __TEST__ && assert(/^<(?:[\!\?]|\/[^a-z>])/i.test(context.source))
+  __TEST__ && assert(matchAt(context, /<(?:[\!\?]|\/[^a-z>])/iy) !== null)
 
   const start = getCursor(context)
-  const contentStart = context.source[1] === '?' ? 1 : 2
+  const source = context.originalSource
+  const offset = context.offset
+  const contentStart = source[offset + 1] === '?' ? 1 : 2
   let content: string
 
-  const closeIndex = context.source.indexOf('>')
+  const closeIndex = source.indexOf('>', offset)
   if (closeIndex === -1) {
-    content = context.source.slice(contentStart)
-    advanceBy(context, context.source.length)
+    content = source.slice(offset + contentStart)
+    advanceBy(context, remaining(context))
   } else {
-    content = context.source.slice(contentStart, closeIndex)
-    advanceBy(context, closeIndex + 1)
+    content = source.slice(offset + contentStart, closeIndex)
+    advanceBy(context, closeIndex - offset + 1)
   }
 
   return {
@@ -452,7 +719,7 @@ function parseElement(
   context: ParserContext,
   ancestors: ElementNode[]
 ): ElementNode | undefined {
-  __TEST__ && assert(/^<[a-z]/i.test(context.source))
+  __TEST__ && assert(matchAt(context, /<[a-z]/iy) !== null)
 
   // Start tag. 解析开始标签
   const wasInPre = context.inPre
@@ -504,13 +771,13 @@ function parseElement(
   element.children = children
 
   // End tag. 解析结束标签
-  if (startsWithEndTagOpen(context.source, element.tag)) {
+  if (startsWithEndTagOpen(context, element.tag)) {
     parseTag(context, TagType.End, parent)
   } else {
     emitError(context, ErrorCodes.X_MISSING_END_TAG, 0, element.loc.start)
-    if (context.source.length === 0 && element.tag.toLowerCase() === 'script') {
+    if (remaining(context) === 0 && element.tag.toLowerCase() === 'script') {
       const first = children[0]
-      if (first && startsWith(first.loc.source, '<!--')) {
+      if (first && first.loc.source.startsWith('<!--')) {
         emitError(context, ErrorCodes.EOF_IN_SCRIPT_HTML_COMMENT_LIKE_TEXT)
       }
     }
@@ -555,15 +822,13 @@ function parseTag(
   type: TagType,
   parent: ElementNode | undefined
 ): ElementNode | undefined {
-  __TEST__ && assert(/^<\/?[a-z]/i.test(context.source))
+  __TEST__ && assert(matchAt(context, /<\/?[a-z]/iy) !== null)
   __TEST__ &&
-    assert(
-      type === (startsWith(context.source, '</') ? TagType.End : TagType.Start)
-    )
+    assert(type === (startsWith(context, '</') ? TagType.End : TagType.Start))
 
   // Tag open. 解析标签
   const start = getCursor(context)
-  const match = /^<\/?([a-z][^\t\r\n\f />]*)/i.exec(context.source)!
+  const match = matchAt(context, tagOpenRE)!
   const tag = match[1]
   const ns = context.options.getNamespace(tag, parent)
 
@@ -572,7 +837,6 @@ function parseTag(
 
   // save current state in case we need to re-parse attributes with v-pre
   const cursor = getCursor(context)
-  const currentSource = context.source
 
   // check <pre> tag
   if (context.options.isPreTag(tag)) {
@@ -591,7 +855,6 @@ function parseTag(
     context.inVPre = true
     // reset context
     extend(context, cursor)
-    context.source = currentSource
     // re-parse attrs and filter out v-pre itself
     props = parseAttributes(context, type).filter(p => p.name !== 'v-pre')
   }
@@ -599,10 +862,10 @@ function parseTag(
   // Tag close. 标签闭合
   // 判断是不是一个自闭和标签，并前进代码到闭合标签后
   let isSelfClosing = false
-  if (context.source.length === 0) {
+  if (remaining(context) === 0) {
     emitError(context, ErrorCodes.EOF_IN_TAG)
   } else {
-    isSelfClosing = startsWith(context.source, '/>')
+    isSelfClosing = startsWith(context, '/>')
     if (type === TagType.End && isSelfClosing) {
       emitError(context, ErrorCodes.END_TAG_WITH_TRAILING_SOLIDUS)
     }
@@ -743,11 +1006,11 @@ function parseAttributes(
   const props = []
   const attributeNames = new Set<string>()
   while (
-    context.source.length > 0 &&
-    !startsWith(context.source, '>') &&
-    !startsWith(context.source, '/>')
+    remaining(context) > 0 &&
+    !startsWith(context, '>') &&
+    !startsWith(context, '/>')
   ) {
-    if (startsWith(context.source, '/')) {
+    if (startsWith(context, '/')) {
       emitError(context, ErrorCodes.UNEXPECTED_SOLIDUS_IN_TAG)
       advanceBy(context, 1)
       advanceSpaces(context)
@@ -773,7 +1036,7 @@ function parseAttributes(
       props.push(attr)
     }
 
-    if (/^[^\t\r\n\f />]/.test(context.source)) {
+    if (matchAt(context, attrNameStartRE)) {
       emitError(context, ErrorCodes.MISSING_WHITESPACE_BETWEEN_ATTRIBUTES)
     }
     advanceSpaces(context)
@@ -785,14 +1048,14 @@ function parseAttribute(
   context: ParserContext,
   nameSet: Set<string>
 ): AttributeNode | DirectiveNode {
-  __TEST__ && assert(/^[^\t\r\n\f />]/.test(context.source))
+  __TEST__ && assert(matchAt(context, attrNameStartRE) !== null)
   // 属性名称、=、属性值
   // 属性/指令
 
   //正则匹配到属性名
   //Name
   const start = getCursor(context)
-  const match = /^[^\t\r\n\f />][^\t\r\n\f />=]*/.exec(context.source)!
+  const match = matchAt(context, attrNameRE)!
   const name = match[0]
 
   //出现相同属性时
@@ -823,7 +1086,7 @@ function parseAttribute(
   // Value
   let value: AttributeValue = undefined
 
-  if (/^[\t\r\n\f ]*=/.test(context.source)) {
+  if (matchAt(context, attrEqualsRE)) {
     advanceSpaces(context)
     advanceBy(context, 1)
     advanceSpaces(context)
@@ -846,12 +1109,12 @@ function parseAttribute(
         name
       )!
 
-    let isPropShorthand = startsWith(name, '.')
+    let isPropShorthand = name.startsWith('.')
     let dirName =
       match[1] ||
-      (isPropShorthand || startsWith(name, ':')
+      (isPropShorthand || name.startsWith(':')
         ? 'bind'
-        : startsWith(name, '@')
+        : name.startsWith('@')
         ? 'on'
         : 'slot')
     let arg: ExpressionNode | undefined
@@ -955,7 +1218,7 @@ function parseAttribute(
   }
 
   // missing directive name or illegal directive name
-  if (!context.inVPre && startsWith(name, 'v-')) {
+  if (!context.inVPre && name.startsWith('v-')) {
     emitError(context, ErrorCodes.X_MISSING_DIRECTIVE_NAME)
   }
 
@@ -978,26 +1241,30 @@ function parseAttributeValue(context: ParserContext): AttributeValue {
 
   // 如果 value值``有引号(「"」or 「'」)开始，那么就找到下一个引号为 value 值结束
   // 如果value值``没有引号，那么就找到下一个空格为 value 值结束
-  const quote = context.source[0]
+  const quote = context.originalSource[context.offset]
   const isQuoted = quote === `"` || quote === `'`
   if (isQuoted) {
     // Quoted value.
     advanceBy(context, 1)
 
-    const endIndex = context.source.indexOf(quote)
+    const endIndex = context.originalSource.indexOf(quote, context.offset)
     if (endIndex === -1) {
       content = parseTextData(
         context,
-        context.source.length,
+        remaining(context),
         TextModes.ATTRIBUTE_VALUE
       )
     } else {
-      content = parseTextData(context, endIndex, TextModes.ATTRIBUTE_VALUE)
+      content = parseTextData(
+        context,
+        endIndex - context.offset,
+        TextModes.ATTRIBUTE_VALUE
+      )
       advanceBy(context, 1)
     }
   } else {
     // Unquoted
-    const match = /^[^\t\r\n\f >]+/.exec(context.source)
+    const match = matchAt(context, unquotedAttrValueRE)
     if (!match) {
       return undefined
     }
@@ -1023,11 +1290,13 @@ function parseInterpolation(
 ): InterpolationNode | undefined {
   // 解析当前配置中插值的开始标记和结束标记
   const [open, close] = context.options.delimiters
-  __TEST__ && assert(startsWith(context.source, open))
+  __TEST__ && assert(startsWith(context, open))
 
   //找到插值的结束分隔符的位置，如果没有找到，就报错。(比如 {{msg}} ,这里是从m开始查找)
-  const closeIndex = context.source.indexOf(close, open.length)
-  if (closeIndex === -1) {
+  const closeIndex =
+    context.originalSource.indexOf(close, context.offset + open.length) -
+    context.offset
+  if (closeIndex < 0) {
     emitError(context, ErrorCodes.X_MISSING_INTERPOLATION_END)
     return undefined
   }
@@ -1037,7 +1306,10 @@ function parseInterpolation(
   const innerStart = getCursor(context)
   const innerEnd = getCursor(context)
   const rawContentLength = closeIndex - open.length
-  const rawContent = context.source.slice(0, rawContentLength)
+  const rawContent = context.originalSource.slice(
+    context.offset,
+    context.offset + rawContentLength
+  )
   const preTrimContent = parseTextData(context, rawContentLength, mode)
   const content = preTrimContent.trim()
   const startOffset = preTrimContent.indexOf(content)
@@ -1066,16 +1338,17 @@ function parseInterpolation(
 
 // 文本节点的解析
 function parseText(context: ParserContext, mode: TextModes): TextNode {
-  __TEST__ && assert(context.source.length > 0)
+  __TEST__ && assert(remaining(context) > 0)
 
   //< ,插值分割符的开头
   const endTokens =
     mode === TextModes.CDATA ? [']]>'] : ['<', context.options.delimiters[0]]
 
-  let endIndex = context.source.length
+  const { originalSource, offset } = context
+  let endIndex = originalSource.length - offset
   for (let i = 0; i < endTokens.length; i++) {
-    const index = context.source.indexOf(endTokens[i], 1)
-    if (index !== -1 && endIndex > index) {
+    const index = originalSource.indexOf(endTokens[i], offset + 1) - offset
+    if (index > 0 && endIndex > index) {
       endIndex = index
     }
   }
@@ -1102,7 +1375,10 @@ function parseTextData(
   length: number,
   mode: TextModes
 ): string {
-  const rawText = context.source.slice(0, length)
+  const rawText = context.originalSource.slice(
+    context.offset,
+    context.offset + length
+  )
   advanceBy(context, length)
   if (
     mode === TextModes.RAWTEXT ||
@@ -1141,20 +1417,54 @@ function last<T>(xs: T[]): T | undefined {
   return xs[xs.length - 1]
 }
 
-function startsWith(source: string, searchString: string): boolean {
-  return source.startsWith(searchString)
+// Sticky (`y`) patterns are matched in place at `context.offset` via
+// `matchAt`, which replaces the `^`-anchored tests against a sliced source.
+const tagOpenRE = /<\/?([a-z][^\t\r\n\f />]*)/iy
+const attrNameStartRE = /[^\t\r\n\f />]/y
+const attrNameRE = /[^\t\r\n\f />][^\t\r\n\f />=]*/y
+const attrEqualsRE = /[\t\r\n\f ]*=/y
+const unquotedAttrValueRE = /[^\t\r\n\f >]+/y
+const spacesRE = /[\t\r\n\f ]+/y
+const endTagDelimiterRE = /[\t\r\n\f />]/
+const commentEndRE = /--(\!)?>/g
+
+function matchAt(context: ParserContext, re: RegExp): RegExpExecArray | null {
+  re.lastIndex = context.offset
+  return re.exec(context.originalSource)
+}
+
+function remaining(context: ParserContext): number {
+  return context.originalSource.length - context.offset
+}
+
+function startsWith(context: ParserContext, searchString: string): boolean {
+  return context.originalSource.startsWith(searchString, context.offset)
 }
 // 递进
 function advanceBy(context: ParserContext, numberOfCharacters: number): void {
-  const { source } = context
-  __TEST__ && assert(numberOfCharacters <= source.length)
+  const { originalSource, offset } = context
+  __TEST__ && assert(numberOfCharacters <= originalSource.length - offset)
   //更新 offset、line、column 和代码位置相关的属性。
-  advancePositionWithMutation(context, source, numberOfCharacters)
-  context.source = source.slice(numberOfCharacters)
+  // inlined advancePositionWithMutation() that reads from the current offset
+  // instead of requiring a sliced copy of the remaining source
+  let linesCount = 0
+  let lastNewLinePos = -1
+  for (let i = 0; i < numberOfCharacters; i++) {
+    if (originalSource.charCodeAt(offset + i) === 10 /* newline char code */) {
+      linesCount++
+      lastNewLinePos = i
+    }
+  }
+  context.offset += numberOfCharacters
+  context.line += linesCount
+  context.column =
+    lastNewLinePos === -1
+      ? context.column + numberOfCharacters
+      : numberOfCharacters - lastNewLinePos
 }
 // 递进 消除空白字符
 function advanceSpaces(context: ParserContext): void {
-  const match = /^[\t\r\n\f ]+/.exec(context.source)
+  const match = matchAt(context, spacesRE)
   if (match) {
     advanceBy(context, match[0].length)
   }
@@ -1196,16 +1506,14 @@ function isEnd(
   mode: TextModes,
   ancestors: ElementNode[]
 ): boolean {
-  const s = context.source
-
   switch (mode) {
     case TextModes.DATA:
-      // context.source 为空，即整个模板都处理完成
+      // 剩余代码为空，即整个模板都处理完成
       // 碰到截止节点标签，且能在 `未匹配的起始标签 ancestors 里面找到对对应的 tag。这个对应 parseChildren 的子节点处理完成。
-      if (startsWith(s, '</')) {
+      if (startsWith(context, '</')) {
         // TODO: probably bad performance
         for (let i = ancestors.length - 1; i >= 0; --i) {
-          if (startsWithEndTagOpen(s, ancestors[i].tag)) {
+          if (startsWithEndTagOpen(context, ancestors[i].tag)) {
             return true
           }
         }
@@ -1215,26 +1523,28 @@ function isEnd(
     case TextModes.RCDATA:
     case TextModes.RAWTEXT: {
       const parent = last(ancestors)
-      if (parent && startsWithEndTagOpen(s, parent.tag)) {
+      if (parent && startsWithEndTagOpen(context, parent.tag)) {
         return true
       }
       break
     }
 
     case TextModes.CDATA:
-      if (startsWith(s, ']]>')) {
+      if (startsWith(context, ']]>')) {
         return true
       }
       break
   }
 
-  return !s
+  return remaining(context) === 0
 }
 
-function startsWithEndTagOpen(source: string, tag: string): boolean {
+function startsWithEndTagOpen(context: ParserContext, tag: string): boolean {
+  const { originalSource: source, offset } = context
+  const end = offset + 2 + tag.length
   return (
-    startsWith(source, '</') &&
-    source.slice(2, 2 + tag.length).toLowerCase() === tag.toLowerCase() &&
-    /[\t\r\n\f />]/.test(source[2 + tag.length] || '>')
+    source.startsWith('</', offset) &&
+    source.slice(offset + 2, end).toLowerCase() === tag.toLowerCase() &&
+    endTagDelimiterRE.test(source[end] || '>')
   )
 }
@@ -1,10 +1,12 @@
 import {
   baseCompile,
   baseParse,
+  baseReparse,
   CompilerOptions,
   CodegenResult,
   ParserOptions,
   RootNode,
+  TemplateEdit,
   noopDirectiveTransform,
   NodeTransform,
   DirectiveTransform
@@ -69,6 +71,14 @@ export function parse(template: string, options: ParserOptions = {}): RootNode {
   return baseParse(template, extend({}, parserOptions, options))
 }
 
+export function reparse(
+  root: RootNode,
+  edit: TemplateEdit,
+  options: ParserOptions = {}
+): RootNode {
+  return baseReparse(root, edit, extend({}, parserOptions, options))
+}
+
 export * from './runtimeHelpers'
 export { transformStyle } from './transforms/transformStyle'
 export { createDOMCompilerError, DOMErrorCodes } from './errors'
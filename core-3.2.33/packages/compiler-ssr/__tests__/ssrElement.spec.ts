@@ -231,7 +231,7 @@ describe('ssr: element', () => {
       expect(getCompiledString(`<div class="foo" v-bind="obj"></div>`))
         .toMatchInlineSnapshot(`
         "\`<div\${
-            _ssrRenderAttrs(_mergeProps({ class: \\"foo\\" }, _ctx.obj))
+            _ssrRenderDynamicAttrs(_ctx.obj, _hoisted_1, \\" class=\\\\\\"foo\\\\\\"\\")
           }></div>\`"
       `)
 
@@ -274,6 +274,55 @@ describe('ssr: element', () => {
       `)
     })
 
+    test('static attrs before v-bind="obj"', () => {
+      // serialized at compile time, up to the first binding
+      expect(
+        compile(
+          `<div id="foo" style="color:red" disabled :title="t" class="a"><span/></div>`
+        ).code
+      ).toMatchInlineSnapshot(`
+        "const { mergeProps: _mergeProps } = require(\\"vue\\")
+        const { ssrRenderDynamicAttrs: _ssrRenderDynamicAttrs } = require(\\"vue/server-renderer\\")
+
+        const _hoisted_1 = {
+          id: \\"foo\\",
+          style: {\\"color\\":\\"red\\"},
+          disabled: \\"\\"
+        }
+
+        return function ssrRender(_ctx, _push, _parent, _attrs) {
+          _push(\`<div\${_ssrRenderDynamicAttrs(_mergeProps({
+            title: _ctx.t,
+            class: \\"a\\"
+          }, _attrs), _hoisted_1, \\" id=\\\\\\"foo\\\\\\" style=\\\\\\"color:red;\\\\\\" disabled\\")}><span></span></div>\`)
+        }"
+      `)
+
+      // attrs after the object are left to runtime, it may override them
+      expect(getCompiledString(`<div v-bind="obj" id="foo"></div>`))
+        .toMatchInlineSnapshot(`
+        "\`<div\${
+            _ssrRenderAttrs(_mergeProps(_ctx.obj, { id: \\"foo\\" }))
+          }></div>\`"
+      `)
+
+      // raw names are preserved on custom elements
+      expect(
+        compile(`<my-foo fooBar="a" v-bind="obj"></my-foo>`, {
+          isCustomElement: () => true
+        }).code
+      ).toMatchInlineSnapshot(`
+        "const { mergeProps: _mergeProps } = require(\\"vue\\")
+        const { ssrRenderDynamicAttrs: _ssrRenderDynamicAttrs } = require(\\"vue/server-renderer\\")
+
+        const _hoisted_1 = { fooBar: \\"a\\" }
+
+        return function ssrRender(_ctx, _push, _parent, _attrs) {
+          _push(\`<my-foo\${_ssrRenderDynamicAttrs(_mergeProps(_ctx.obj, _attrs), _hoisted_1, \\" fooBar=\\\\\\"a\\\\\\"\\", \\"my-foo\\")}></my-foo>\`)
+        }"
+      `)
+    })
+
     test('should ignore v-on', () => {
       expect(
         getCompiledString(`<div id="foo" @click="bar"/>`)
@@ -301,7 +350,7 @@ describe('ssr: element', () => {
       expect(getCompiledString(`<div class="foo" v-xxx />`))
         .toMatchInlineSnapshot(`
         "\`<div\${
-            _ssrRenderAttrs(_mergeProps({ class: \\"foo\\" }, _ssrGetDirectiveProps(_ctx, _directive_xxx)))
+            _ssrRenderDynamicAttrs(_ssrGetDirectiveProps(_ctx, _directive_xxx), _hoisted_1, \\" class=\\\\\\"foo\\\\\\"\\")
           }></div>\`"
       `)
     })
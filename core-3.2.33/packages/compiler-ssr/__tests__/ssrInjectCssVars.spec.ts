@@ -100,14 +100,14 @@ describe('ssr: inject <style vars>', () => {
       return function ssrRender(_ctx, _push, _parent, _attrs) {
         const _cssVars = { style: { color: _ctx.color }}
         _ssrRenderSuspense(_push, {
-          fallback: () => {
+          fallback: (_push) => {
             _push(\`<div\${_ssrRenderAttrs(_cssVars)}>fallback</div>\`)
           },
-          default: () => {
+          default: (_push) => {
             _push(\`<div\${_ssrRenderAttrs(_cssVars)}>ok</div>\`)
           },
           _: 1 /* STABLE */
-        })
+        }, _parent)
       }"
     `)
   })
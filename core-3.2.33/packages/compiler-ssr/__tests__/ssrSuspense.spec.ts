@@ -10,11 +10,11 @@ describe('ssr compile: suspense', () => {
         const _component_foo = _resolveComponent(\\"foo\\")
 
         _ssrRenderSuspense(_push, {
-          default: () => {
+          default: (_push) => {
             _push(_ssrRenderComponent(_component_foo, null, null, _parent))
           },
           _: 1 /* STABLE */
-        })
+        }, _parent)
       }"
     `)
   })
@@ -37,14 +37,14 @@ describe('ssr compile: suspense', () => {
         const _component_foo = _resolveComponent(\\"foo\\")
 
         _ssrRenderSuspense(_push, {
-          default: () => {
+          default: (_push) => {
             _push(_ssrRenderComponent(_component_foo, null, null, _parent))
           },
-          fallback: () => {
+          fallback: (_push) => {
             _push(\` loading... \`)
           },
           _: 1 /* STABLE */
-        })
+        }, _parent)
       }"
     `)
   })
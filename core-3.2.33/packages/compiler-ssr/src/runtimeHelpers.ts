@@ -9,6 +9,7 @@ export const SSR_RENDER_STYLE = Symbol(`ssrRenderStyle`)
 export const SSR_RENDER_ATTRS = Symbol(`ssrRenderAttrs`)
 export const SSR_RENDER_ATTR = Symbol(`ssrRenderAttr`)
 export const SSR_RENDER_DYNAMIC_ATTR = Symbol(`ssrRenderDynamicAttr`)
+export const SSR_RENDER_DYNAMIC_ATTRS = Symbol(`ssrRenderDynamicAttrs`)
 export const SSR_RENDER_LIST = Symbol(`ssrRenderList`)
 export const SSR_INCLUDE_BOOLEAN_ATTR = Symbol(`ssrIncludeBooleanAttr`)
 export const SSR_LOOSE_EQUAL = Symbol(`ssrLooseEqual`)
@@ -29,6 +30,7 @@ export const ssrHelpers = {
   [SSR_RENDER_ATTRS]: `ssrRenderAttrs`,
   [SSR_RENDER_ATTR]: `ssrRenderAttr`,
   [SSR_RENDER_DYNAMIC_ATTR]: `ssrRenderDynamicAttr`,
+  [SSR_RENDER_DYNAMIC_ATTRS]: `ssrRenderDynamicAttrs`,
   [SSR_RENDER_LIST]: `ssrRenderList`,
   [SSR_INCLUDE_BOOLEAN_ATTR]: `ssrIncludeBooleanAttr`,
   [SSR_LOOSE_EQUAL]: `ssrLooseEqual`,
@@ -29,15 +29,23 @@ import {
   AttributeNode,
   buildDirectiveArgs,
   TransformContext,
-  PropsExpression
+  PropsExpression,
+  createObjectExpression,
+  SimpleExpressionNode,
+  ConstantTypes
 } from '@vue/compiler-dom'
 import {
   escapeHtml,
   isBooleanAttr,
   isBuiltInDirective,
+  isOn,
   isSSRSafeAttrName,
+  makeMap,
   NO,
-  propsToAttrMap
+  normalizeClass,
+  normalizeStyle,
+  propsToAttrMap,
+  stringifyStyle
 } from '@vue/shared'
 import { createSSRCompilerError, SSRErrorCodes } from '../errors'
 import {
@@ -45,6 +53,7 @@ import {
   SSR_RENDER_CLASS,
   SSR_RENDER_STYLE,
   SSR_RENDER_DYNAMIC_ATTR,
+  SSR_RENDER_DYNAMIC_ATTRS,
   SSR_RENDER_ATTRS,
   SSR_INTERPOLATE,
   SSR_GET_DYNAMIC_MODEL_PROPS,
@@ -159,6 +168,24 @@ export const ssrTransformElement: NodeTransform = (node, context) => {
           }
         }
 
+        if (node.tag !== 'textarea' && propsExp.arguments[0] === mergedProps) {
+          // serialize leading static attrs at compile time so that only the
+          // dynamic props are walked at runtime
+          const split = splitStaticAttrs(mergedProps, node.tag)
+          if (split) {
+            if (split.dynamicProps !== mergedProps) {
+              context.removeHelper(MERGE_PROPS)
+            }
+            context.removeHelper(SSR_RENDER_ATTRS)
+            propsExp.callee = context.helper(SSR_RENDER_DYNAMIC_ATTRS)
+            propsExp.arguments = [
+              split.dynamicProps,
+              context.hoist(split.staticProps),
+              JSON.stringify(split.staticAttrs)
+            ]
+          }
+        }
+
         if (needTagForRuntime) {
           propsExp.arguments.push(`"${node.tag}"`)
         }
@@ -347,11 +374,100 @@ export function buildSSRProps(
     }
   }
 
+  if (props && props.type === NodeTypes.JS_CALL_EXPRESSION) {
+    // the directive props were pushed into its arguments
+    return props
+  }
   return mergePropsArgs.length > 1
     ? createCallExpression(context.helper(MERGE_PROPS), mergePropsArgs)
     : mergePropsArgs[0]
 }
 
+// keep in sync with the props skipped by ssrRenderAttrs
+const isIgnoredProp = makeMap(`key,ref,innerHTML,textContent,ref_key,ref_for`)
+
+/**
+ * Splits merged props of the form `mergeProps({ id: "a", ... }, obj)` into
+ * the leading run of static attrs, serialized exactly as `ssrRenderAttrs`
+ * would render them, and the remaining props. Attrs that can't be known at
+ * compile time (bindings, unsafe names) end the run so that attribute order
+ * is preserved.
+ */
+function splitStaticAttrs(props: JSChildNode, tag: string) {
+  if (props.type !== NodeTypes.JS_CALL_EXPRESSION) {
+    return
+  }
+  const [first, ...rest] = props.arguments as JSChildNode[]
+  if (first.type !== NodeTypes.JS_OBJECT_EXPRESSION) {
+    return
+  }
+
+  let staticAttrs = ``
+  let i = 0
+  const properties = first.properties
+  for (; i < properties.length; i++) {
+    const { key, value } = properties[i]
+    if (!isStaticExp(key) || value.type !== NodeTypes.SIMPLE_EXPRESSION) {
+      break
+    }
+    const attr = serializeStaticAttr(key.content, value, tag)
+    if (attr == null) {
+      break
+    }
+    staticAttrs += attr
+  }
+  if (!i) {
+    return
+  }
+
+  const dynamicArgs = rest
+  if (i < properties.length) {
+    dynamicArgs.unshift(createObjectExpression(properties.slice(i)))
+  }
+  props.arguments = dynamicArgs
+  return {
+    staticAttrs,
+    staticProps: createObjectExpression(properties.slice(0, i)),
+    dynamicProps: dynamicArgs.length > 1 ? props : dynamicArgs[0]
+  }
+}
+
+function serializeStaticAttr(
+  key: string,
+  { content: value, isStatic, constType }: SimpleExpressionNode,
+  tag: string
+): string | undefined {
+  if (!isStatic) {
+    // static style attrs have been parsed into an object by transformStyle
+    if (key === 'style' && constType === ConstantTypes.CAN_STRINGIFY) {
+      try {
+        const style = normalizeStyle([JSON.parse(value)])
+        return ` style="${escapeHtml(stringifyStyle(style))}"`
+      } catch (e) {}
+    }
+    return
+  }
+  if (isIgnoredProp(key) || isOn(key)) {
+    return ``
+  }
+  if (key === 'class') {
+    // mergeProps normalizes (and trims) the class
+    return ` class="${escapeHtml(normalizeClass([value]))}"`
+  }
+  if (key === 'style') {
+    return
+  }
+  const attrName =
+    tag.indexOf('-') > 0
+      ? key // preserve raw name on custom elements
+      : propsToAttrMap[key] || key.toLowerCase()
+  if (isBooleanAttr(attrName)) {
+    return ` ${attrName}`
+  } else if (isSSRSafeAttrName(attrName)) {
+    return value === '' ? ` ${attrName}` : ` ${attrName}="${escapeHtml(value)}"`
+  }
+}
+
 function isTrueFalseValue(prop: DirectiveNode | AttributeNode) {
   if (prop.type === NodeTypes.DIRECTIVE) {
     return (
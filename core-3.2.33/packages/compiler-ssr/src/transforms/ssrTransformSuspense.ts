@@ -37,8 +37,10 @@ export function ssrTransformSuspense(
       }
       wipMap.set(node, wipEntry)
       wipEntry.slotsExp = buildSlots(node, context, (_props, children, loc) => {
+        // slots receive the push function to render into, so that the
+        // content can be buffered separately when streaming out of order
         const fn = createFunctionExpression(
-          [],
+          [`_push`],
           undefined, // no return, assign body later
           true, // newline
           false, // suspense slots are not treated as normal slots
@@ -69,11 +71,12 @@ export function ssrProcessSuspense(
     const { fn, children } = wipSlots[i]
     fn.body = processChildrenAsStatement(children, context)
   }
-  // _push(ssrRenderSuspense(slots))
+  // ssrRenderSuspense(_push, slots, _parent)
   context.pushStatement(
     createCallExpression(context.helper(SSR_RENDER_SUSPENSE), [
       `_push`,
-      slotsExp
+      slotsExp,
+      `_parent`
     ])
   )
 }
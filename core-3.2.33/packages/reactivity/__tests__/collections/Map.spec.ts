@@ -1,4 +1,11 @@
-import { reactive, effect, toRaw, isReactive } from '../../src'
+import {
+  reactive,
+  readonly,
+  effect,
+  toRaw,
+  isReactive,
+  iterateRaw
+} from '../../src'
 
 describe('reactivity/collections', () => {
   function coverCollectionFn(collection: Map<any, any>, fnName: string) {
@@ -468,6 +475,59 @@ describe('reactivity/collections', () => {
       expect(spy).toBeCalledTimes(1)
     })
 
+    it('should iterate raw entries with iterateRaw', () => {
+      const value = { count: 0 }
+      const map = reactive(new Map([['a', value]]))
+      let entries: [string, { count: number }][] = []
+      const spy = jest.fn(() => {
+        entries = [...iterateRaw(map)]
+      })
+      effect(spy)
+      expect(spy).toHaveBeenCalledTimes(1)
+      expect(entries[0][0]).toBe('a')
+      expect(entries[0][1]).toBe(value)
+      expect(isReactive(entries[0][1])).toBe(false)
+
+      // raw values are not tracked
+      map.get('a')!.count++
+      expect(spy).toHaveBeenCalledTimes(1)
+      map.set('b', value)
+      expect(spy).toHaveBeenCalledTimes(2)
+      map.delete('b')
+      expect(spy).toHaveBeenCalledTimes(3)
+    })
+
+    it('should only track key changes with iterateRaw(map, "keys")', () => {
+      const map = reactive(new Map([['a', 1]]))
+      let keys: string[] = []
+      const spy = jest.fn(() => {
+        keys = [...iterateRaw(map, 'keys')]
+      })
+      effect(spy)
+      expect(keys).toEqual(['a'])
+
+      map.set('a', 2)
+      expect(spy).toHaveBeenCalledTimes(1)
+      map.set('b', 3)
+      expect(spy).toHaveBeenCalledTimes(2)
+      expect(keys).toEqual(['a', 'b'])
+    })
+
+    it('should track iterateRaw through readonly(reactive(Map))', () => {
+      const map = reactive(new Map<string, number>())
+      let values: number[] = []
+      effect(() => {
+        values = [...iterateRaw(readonly(map), 'values')]
+      })
+      map.set('a', 1)
+      expect(values).toEqual([1])
+
+      // plain readonly collections are not tracked
+      const spy = jest.fn(() => [...iterateRaw(readonly(new Map()))])
+      effect(spy)
+      expect(spy).toHaveBeenCalledTimes(1)
+    })
+
     it('should return proxy from Map.set call', () => {
       const map = reactive(new Map())
       const result = map.set('a', 'a')
@@ -119,6 +119,66 @@ describe('reactivity/computed', () => {
     expect(getter2).toHaveBeenCalledTimes(2)
   })
 
+  it('should not trigger effect when computed value is unchanged', () => {
+    const value = ref(0)
+    const getter = jest.fn(() => value.value % 2 === 0)
+    const isEven = computed(getter)
+    let dummy
+    const effectSpy = jest.fn(() => (dummy = isEven.value))
+    effect(effectSpy)
+    expect(effectSpy).toHaveBeenCalledTimes(1)
+
+    value.value = 2
+    expect(getter).toHaveBeenCalledTimes(2)
+    expect(effectSpy).toHaveBeenCalledTimes(1)
+
+    value.value = 3
+    expect(getter).toHaveBeenCalledTimes(3)
+    expect(effectSpy).toHaveBeenCalledTimes(2)
+    expect(dummy).toBe(false)
+  })
+
+  it('should stop propagating at an unchanged computed when chained', () => {
+    const value = ref(0)
+    const getter1 = jest.fn(() => value.value % 2)
+    const getter2 = jest.fn(() => c1.value + 1)
+    const c1 = computed(getter1)
+    const c2 = computed(getter2)
+    const effectSpy = jest.fn(() => c2.value)
+    effect(effectSpy)
+
+    value.value = 2
+    expect(getter1).toHaveBeenCalledTimes(2)
+    expect(getter2).toHaveBeenCalledTimes(1)
+    expect(effectSpy).toHaveBeenCalledTimes(1)
+
+    value.value = 3
+    expect(getter2).toHaveBeenCalledTimes(2)
+    expect(effectSpy).toHaveBeenCalledTimes(2)
+    expect(c2.value).toBe(2)
+  })
+
+  it('should expose whether a scheduled effect is dirty', () => {
+    const value = ref(0)
+    const other = ref(0)
+    const isEven = computed(() => value.value % 2 === 0)
+    const runner = effect(() => `${isEven.value}-${other.value}`, {
+      scheduler: () => {}
+    })
+    expect(runner.effect.dirty).toBe(false)
+
+    // notified by the computed, but its value did not change
+    value.value = 2
+    expect(runner.effect.dirty).toBe(false)
+    value.value = 3
+    expect(runner.effect.dirty).toBe(true)
+    expect(runner()).toBe('false-0')
+    expect(runner.effect.dirty).toBe(false)
+
+    other.value = 1
+    expect(runner.effect.dirty).toBe(true)
+  })
+
   it('should no longer update when stopped', () => {
     const value = reactive<{ foo?: number }>({})
     const cValue = computed(() => value.foo)
@@ -10,9 +10,13 @@ import {
   markRaw,
   shallowReactive,
   readonly,
-  ReactiveEffectRunner
+  ReactiveEffectRunner,
+  computed,
+  batch,
+  startBatch,
+  endBatch
 } from '../src/index'
-import { ITERATE_KEY } from '../src/effect'
+import { ITERATE_KEY, getDepFromReactive } from '../src/effect'
 
 describe('reactivity/effect', () => {
   it('should run the passed function once (wrapped by a effect)', () => {
@@ -509,6 +513,34 @@ describe('reactivity/effect', () => {
     expect(results[39]).toBe(Math.pow(2, 39))
   })
 
+  it('should track and clean up deps at any nesting depth', () => {
+    const toggle = ref(true)
+    const a = ref(1)
+    const b = ref(2)
+    let c = computed(() => (toggle.value ? a.value : b.value))
+    // each computed is evaluated inside the previous one: 200 levels deep
+    for (let i = 0; i < 200; i++) {
+      const prev = c
+      c = computed(() => prev.value + 1)
+    }
+    let dummy
+    const spy = jest.fn(() => (dummy = c.value))
+    effect(spy)
+    expect(dummy).toBe(201)
+
+    a.value = 5
+    expect(dummy).toBe(205)
+    toggle.value = false
+    expect(dummy).toBe(202)
+    expect(spy).toHaveBeenCalledTimes(3)
+    // no longer a dep of the innermost computed
+    a.value = 10
+    expect(spy).toHaveBeenCalledTimes(3)
+    b.value = 3
+    expect(dummy).toBe(203)
+    expect(spy).toHaveBeenCalledTimes(4)
+  })
+
   it('should register deps independently during effect recursion', () => {
     const input = reactive({ a: 1, b: 2, c: 0 })
     const output = reactive({ fx1: 0, fx2: 0 })
@@ -639,6 +671,44 @@ describe('reactivity/effect', () => {
     expect(childSpy).toHaveBeenCalledTimes(5)
   })
 
+  it('should keep a single subscription when nested effects share deps', () => {
+    const obj = reactive({ foo: 1, bar: 1 })
+    const childSpy = jest.fn(() => obj.foo + obj.bar)
+    const child = effect(childSpy, { lazy: true })
+    const parentSpy = jest.fn(() => {
+      obj.foo
+      child()
+      obj.foo
+      obj.bar
+    })
+    const parent = effect(parentSpy)
+    const subscribers = () => {
+      const subs = []
+      for (let link = (child.effect.deps as any).dep.subsHead; link; ) {
+        subs.push(link.sub)
+        link = link.nextSub
+      }
+      return subs
+    }
+    expect(subscribers()).toEqual([parent.effect, child.effect])
+
+    // re-run parent: links are reused and not duplicated
+    obj.bar++
+    expect(parentSpy).toHaveBeenCalledTimes(2)
+    expect(childSpy).toHaveBeenCalledTimes(3)
+    expect(subscribers()).toEqual([parent.effect, child.effect])
+
+    obj.foo++
+    expect(parentSpy).toHaveBeenCalledTimes(3)
+    expect(childSpy).toHaveBeenCalledTimes(5)
+
+    stop(parent)
+    expect(subscribers()).toEqual([child.effect])
+    obj.foo++
+    expect(parentSpy).toHaveBeenCalledTimes(3)
+    expect(childSpy).toHaveBeenCalledTimes(6)
+  })
+
   it('should observe json methods', () => {
     let dummy = <Record<string, number>>{}
     const obj = reactive<Record<string, number>>({})
@@ -803,9 +873,9 @@ describe('reactivity/effect', () => {
   })
 
   // #5707
-  // when an effect completes its run, it should clear the tracking bits of
+  // when an effect completes its run, it should restore the active links of
   // its tracked deps. However, if the effect stops itself, the deps list is
-  // emptied so their bits are never cleared.
+  // emptied so the links are never restored.
   it('edge case: self-stopping effect tracking ref', () => {
     const c = ref(true)
     const runner = effect(() => {
@@ -817,9 +887,9 @@ describe('reactivity/effect', () => {
     })
     // trigger run
     c.value = !c.value
-    // should clear bits
-    expect((c as any).dep.w).toBe(0)
-    expect((c as any).dep.n).toBe(0)
+    // should restore active link
+    expect((c as any).dep.activeLink).toBeUndefined()
+    expect((c as any).dep.subsHead).toBeUndefined()
   })
 
   it('events: onStop', () => {
@@ -954,4 +1024,188 @@ describe('reactivity/effect', () => {
       expect(fnSpy).toHaveBeenCalledTimes(2)
     })
   })
+
+  describe('dep cleanup', () => {
+    it('should remove deps that lost their last subscriber', () => {
+      const raw = { a: 1, b: 2 }
+      const obj = reactive(raw)
+      const useA = ref(true)
+      const runner = effect(() => (useA.value ? obj.a : obj.b))
+      expect(getDepFromReactive(raw, 'a')).toBeDefined()
+      expect(getDepFromReactive(raw, 'b')).toBeUndefined()
+
+      useA.value = false
+      expect(getDepFromReactive(raw, 'a')).toBeUndefined()
+      expect(getDepFromReactive(raw, 'b')).toBeDefined()
+
+      stop(runner)
+      expect(getDepFromReactive(raw, 'b')).toBeUndefined()
+    })
+
+    it('should keep deps that still have subscribers', () => {
+      const raw = { a: 1 }
+      const obj = reactive(raw)
+      const runner1 = effect(() => obj.a)
+      const fnSpy = jest.fn(() => obj.a)
+      effect(fnSpy)
+
+      stop(runner1)
+      expect(getDepFromReactive(raw, 'a')).toBeDefined()
+      obj.a++
+      expect(fnSpy).toHaveBeenCalledTimes(2)
+    })
+
+    it('should track again after the dep was removed', () => {
+      const raw = { a: 1 }
+      const obj = reactive(raw)
+      stop(effect(() => obj.a))
+      expect(getDepFromReactive(raw, 'a')).toBeUndefined()
+
+      const fnSpy = jest.fn(() => obj.a)
+      effect(fnSpy)
+      obj.a++
+      expect(fnSpy).toHaveBeenCalledTimes(2)
+    })
+
+    // scripts/bench/keyChurn.js measures the retained heap over a million
+    it('should not accumulate deps over key churns', () => {
+      const raw = new Map<number, number>()
+      const cache = reactive(raw)
+      const id = ref(0)
+      let value: number | undefined
+      effect(() => {
+        value = cache.get(id.value)
+      })
+
+      const CHURNS = 300
+      for (let i = 1; i <= CHURNS; i++) {
+        cache.set(i, i)
+        id.value = i
+        cache.delete(i - 1)
+      }
+      expect(value).toBe(CHURNS)
+      // only the key currently read still has a dep
+      const dep = getDepFromReactive(raw, CHURNS)!
+      expect(dep).toBeDefined()
+      expect(dep.map!.size).toBe(1)
+    })
+  })
+
+  describe('batch', () => {
+    it('should run triggered effects once after the batch', () => {
+      const list = reactive<number[]>([])
+      const map = reactive(new Map<number, number>())
+      let dummy
+      const fnSpy = jest.fn(() => (dummy = list.length + map.size))
+      effect(fnSpy)
+
+      batch(() => {
+        for (let i = 0; i < 100; i++) {
+          list.push(i)
+          map.set(i, i)
+        }
+        expect(fnSpy).toHaveBeenCalledTimes(1)
+      })
+      expect(fnSpy).toHaveBeenCalledTimes(2)
+      expect(dummy).toBe(200)
+    })
+
+    it('should call schedulers once', () => {
+      const obj = reactive({ a: 1, b: 1 })
+      const scheduler = jest.fn()
+      effect(() => obj.a + obj.b, { scheduler })
+
+      batch(() => {
+        obj.a++
+        obj.b++
+        obj.a++
+      })
+      expect(scheduler).toHaveBeenCalledTimes(1)
+    })
+
+    it('should run effects in the order they were first triggered', () => {
+      const obj = reactive({ a: 1, b: 1 })
+      const calls: string[] = []
+      effect(() => calls.push(`a${obj.a}`))
+      effect(() => calls.push(`b${obj.b}`))
+      calls.length = 0
+
+      batch(() => {
+        obj.b++
+        obj.a++
+        obj.b++
+      })
+      expect(calls).toEqual(['b3', 'a2'])
+    })
+
+    it('should flush when the outermost batch ends', () => {
+      const count = ref(0)
+      const fnSpy = jest.fn(() => count.value)
+      effect(fnSpy)
+
+      startBatch()
+      count.value++
+      batch(() => count.value++)
+      expect(fnSpy).toHaveBeenCalledTimes(1)
+      count.value++
+      endBatch()
+      expect(fnSpy).toHaveBeenCalledTimes(2)
+    })
+
+    it('should keep computeds up to date during the batch', () => {
+      const count = ref(0)
+      const double = computed(() => count.value * 2)
+      const fnSpy = jest.fn(() => double.value)
+      effect(fnSpy)
+
+      batch(() => {
+        count.value++
+        expect(double.value).toBe(2)
+        count.value++
+        expect(double.value).toBe(4)
+      })
+      expect(fnSpy).toHaveBeenCalledTimes(2)
+    })
+
+    it('should not run effects whose computeds end up unchanged', () => {
+      const count = ref(0)
+      const isEven = computed(() => count.value % 2 === 0)
+      const fnSpy = jest.fn(() => isEven.value)
+      effect(fnSpy)
+
+      batch(() => {
+        count.value++
+        count.value++
+      })
+      expect(fnSpy).toHaveBeenCalledTimes(1)
+    })
+
+    it('should not run effects stopped during the batch', () => {
+      const count = ref(0)
+      const fnSpy = jest.fn(() => count.value)
+      const runner = effect(fnSpy)
+
+      batch(() => {
+        count.value++
+        stop(runner)
+      })
+      expect(fnSpy).toHaveBeenCalledTimes(1)
+    })
+
+    it('should run remaining effects and rethrow if an effect throws', () => {
+      const count = ref(0)
+      effect(() => {
+        if (count.value === 1) throw new Error('fail')
+      })
+      const fnSpy = jest.fn(() => count.value)
+      effect(fnSpy)
+
+      expect(() => batch(() => count.value++)).toThrow('fail')
+      expect(fnSpy).toHaveBeenCalledTimes(2)
+
+      // batch state is reset
+      count.value++
+      expect(fnSpy).toHaveBeenCalledTimes(3)
+    })
+  })
 })
@@ -220,6 +220,27 @@ describe('reactivity/effect/scope', () => {
     expect(parent.scopes!.includes(child)).toBe(false)
   })
 
+  it('should release parent, child scopes and cleanups once stopped', () => {
+    const parent = new EffectScope()
+    const spy = jest.fn()
+    let child: EffectScope
+    parent.run(() => {
+      child = new EffectScope()
+      child.run(() => onScopeDispose(spy))
+    })
+
+    parent.stop()
+    expect(spy).toHaveBeenCalledTimes(1)
+    expect(child!.active).toBe(false)
+    expect(child!.parent).toBeUndefined()
+    expect(child!.cleanups.length).toBe(0)
+    expect(parent.scopes).toBeUndefined()
+
+    // stopping again is a no-op
+    child!.stop()
+    expect(spy).toHaveBeenCalledTimes(1)
+  })
+
   it('test with higher level APIs', async () => {
     const r = ref(1)
 
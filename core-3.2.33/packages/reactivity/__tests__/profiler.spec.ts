@@ -0,0 +1,133 @@
+import {
+  reactive,
+  ref,
+  computed,
+  effect,
+  stop,
+  toRaw,
+  startProfiling,
+  stopProfiling,
+  toChromeTrace
+} from '../src'
+
+describe('reactivity/profiler', () => {
+  afterEach(() => {
+    stopProfiling()
+  })
+
+  it('should record runs, deps and run time of effects', () => {
+    const state = reactive({ a: 1, b: 2 })
+    startProfiling()
+    const runner = effect(function sum() {
+      return state.a + state.b
+    })
+    state.a++
+    state.b++
+    const { effects, duration } = stopProfiling()
+
+    expect(effects.length).toBe(1)
+    const [profile] = effects
+    expect(profile.effect).toBe(runner.effect)
+    expect(profile.kind).toBe('effect')
+    expect(profile.name).toBe('sum')
+    expect(profile.runs).toBe(3)
+    expect(profile.deps).toBe(2)
+    expect(profile.triggers).toBe(2)
+    expect(profile.time).toBeGreaterThanOrEqual(0)
+    expect(profile.selfTime).toBeLessThanOrEqual(profile.time)
+    expect(duration).toBeGreaterThanOrEqual(profile.time)
+  })
+
+  it('should report the target and key that triggered an effect the most', () => {
+    const state = reactive({ a: 1, b: 2 })
+    const count = ref(0)
+    effect(() => state.a + state.b + count.value)
+    startProfiling()
+    state.a++
+    state.b++
+    state.b++
+    count.value++
+    const [profile] = stopProfiling().effects
+
+    expect(profile.triggers).toBe(4)
+    expect(profile.topTrigger).toMatchObject({
+      target: toRaw(state),
+      key: 'b',
+      count: 2
+    })
+  })
+
+  it('should profile computeds and attribute notifications to them', () => {
+    const count = ref(1)
+    const double = computed(() => count.value * 2)
+    startProfiling()
+    const runner = effect(() => double.value)
+    count.value++
+    const { effects } = stopProfiling()
+
+    const computedProfile = effects.find(p => p.kind === 'computed')!
+    expect(computedProfile.effect).toBe(double.effect)
+    expect(computedProfile.runs).toBe(2)
+    expect(computedProfile.topTrigger!.target).toBe(count)
+
+    const effectProfile = effects.find(p => p.effect === runner.effect)!
+    expect(effectProfile.runs).toBe(2)
+    expect(effectProfile.topTrigger!.target).toBe(toRaw(double))
+    expect(effectProfile.topTrigger!.key).toBe('value')
+  })
+
+  it('should exclude nested runs from self time', () => {
+    const count = ref(0)
+    startProfiling()
+    effect(function outer() {
+      effect(function inner() {
+        const start = Date.now()
+        while (Date.now() - start < 5) {}
+        return count.value
+      })
+    })
+    const { effects } = stopProfiling()
+
+    const outer = effects.find(p => p.name === 'outer')!
+    const inner = effects.find(p => p.name === 'inner')!
+    expect(outer.time).toBeGreaterThanOrEqual(inner.time)
+    expect(outer.selfTime).toBeLessThan(inner.time)
+    // sorted by self time
+    expect(effects[0]).toBe(inner)
+  })
+
+  it('should not record anything when not profiling', () => {
+    const count = ref(0)
+    const runner = effect(() => count.value)
+    count.value++
+    startProfiling()
+    const { effects, events } = stopProfiling()
+    expect(effects.length).toBe(0)
+    expect(events).toBeUndefined()
+
+    count.value++
+    startProfiling()
+    stop(runner)
+    expect(stopProfiling().effects.length).toBe(0)
+  })
+
+  it('should export runs as Chrome trace events', () => {
+    const count = ref(0)
+    startProfiling({ trace: true })
+    effect(function render() {
+      return count.value
+    })
+    count.value++
+    const { traceEvents } = toChromeTrace(stopProfiling())
+
+    expect(traceEvents.length).toBe(2)
+    expect(traceEvents[0]).toMatchObject({
+      name: 'effect render',
+      cat: 'effect',
+      ph: 'X',
+      args: { deps: 1 }
+    })
+    expect(traceEvents[1].ts).toBeGreaterThanOrEqual(traceEvents[0].ts)
+    expect(JSON.parse(JSON.stringify(traceEvents))).toEqual(traceEvents)
+  })
+})
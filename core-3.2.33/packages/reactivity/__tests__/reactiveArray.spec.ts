@@ -1,6 +1,14 @@
-import { reactive, isReactive, toRaw } from '../src/reactive'
+import {
+  reactive,
+  isReactive,
+  isReadonly,
+  toRaw,
+  shallowReactive,
+  readonly,
+  shallowReadonly
+} from '../src/reactive'
 import { ref, isRef } from '../src/ref'
-import { effect } from '../src/effect'
+import { effect, ReactiveEffectRunner } from '../src/effect'
 
 describe('reactivity/reactive/Array', () => {
   test('should make Array reactive', () => {
@@ -88,6 +96,123 @@ describe('reactivity/reactive/Array', () => {
     expect(index).toBe(1)
   })
 
+  describe('Array search and iteration methods', () => {
+    const countDeps = (runner: ReactiveEffectRunner) => {
+      let count = 0
+      for (let link = runner.effect.deps; link; link = link.nextDep) count++
+      return count
+    }
+
+    test('should track the whole array with a single dep', () => {
+      const arr = reactive(Array.from({ length: 1000 }, (_, i) => i))
+      const runner = effect(() => {
+        arr.indexOf(-1)
+        arr.includes(-1)
+        arr.map(v => v)
+        arr.filter(v => v > 500)
+        arr.find(v => v < 0)
+        arr.forEach(() => {})
+        arr.reduce((a, b) => a + b)
+        arr.some(v => v < 0)
+        arr.every(v => v >= 0)
+        arr.join()
+      })
+      expect(countDeps(runner)).toBe(1)
+    })
+
+    test('should be triggered by element and length changes', () => {
+      const arr = reactive([1, 2, 3])
+      let sum = 0
+      const fn = jest.fn(() => (sum = arr.reduce((a, b) => a + b, 0)))
+      effect(fn)
+      expect(sum).toBe(6)
+
+      arr[1] = 5
+      expect(sum).toBe(9)
+      arr.push(1)
+      expect(sum).toBe(10)
+      arr.length = 1
+      expect(sum).toBe(1)
+      delete arr[0]
+      expect(sum).toBe(0)
+      expect(fn).toHaveBeenCalledTimes(5)
+
+      // not an element
+      // @ts-ignore
+      arr.x = 1
+      expect(fn).toHaveBeenCalledTimes(5)
+    })
+
+    test('should keep per-index tracking for direct reads', () => {
+      const arr = reactive([1, 2, 3])
+      const fn = jest.fn(() => arr[0])
+      effect(fn)
+      arr[1] = 5
+      expect(fn).toHaveBeenCalledTimes(1)
+      arr[0] = 5
+      expect(fn).toHaveBeenCalledTimes(2)
+    })
+
+    test('should pass reactive elements to callbacks and return them', () => {
+      const raw = [{ id: 1 }, { id: 2 }]
+      const arr = reactive(raw)
+      const seen: unknown[] = []
+      arr.forEach((item, index, array) => {
+        seen.push(item)
+        expect(array).toBe(arr)
+        expect(index).toBe(seen.length - 1)
+      })
+      expect(seen.every(isReactive)).toBe(true)
+      expect(isReactive(arr.find(item => item.id === 2))).toBe(true)
+      expect(arr.filter(item => item.id > 0).every(isReactive)).toBe(true)
+      expect(arr.map(item => isReactive(item))).toEqual([true, true])
+      expect(isReactive(arr.reduce(acc => acc))).toBe(true)
+      expect(arr.findIndex(item => item.id === 2)).toBe(1)
+      expect(arr.some(item => item === raw[0])).toBe(false)
+      expect(arr.every(item => isReactive(item))).toBe(true)
+    })
+
+    test('should pass raw elements for shallowReactive arrays', () => {
+      const raw = [{ id: 1 }]
+      const arr = shallowReactive(raw)
+      expect(arr.find(() => true)).toBe(raw[0])
+      expect(arr.map(item => item)[0]).toBe(raw[0])
+    })
+
+    test('should pass readonly elements for readonly reactive arrays', () => {
+      const cases = [
+        readonly(reactive([{ id: 1 }])),
+        readonly(shallowReactive([{ id: 1 }])),
+        shallowReadonly(readonly(reactive([{ id: 1 }])))
+      ]
+      for (const arr of cases) {
+        const item = arr[0]
+        expect(isReadonly(item)).toBe(true)
+        arr.forEach(value => expect(value).toBe(item))
+        expect(arr.map(value => isReadonly(value))).toEqual([true])
+        expect(arr.find(() => true)).toBe(item)
+        expect(arr.filter(() => true)[0]).toBe(item)
+        expect(arr.reduce(acc => acc)).toBe(item)
+        expect(arr.every(value => isReadonly(value))).toBe(true)
+        // readonly data cannot be written through the callback argument
+        arr.forEach(value => ((value as any).id = 2))
+        expect(arr[0].id).toBe(1)
+        expect(`target is readonly`).toHaveBeenWarned()
+      }
+    })
+
+    test('should pass the same elements as index access', () => {
+      const cases = [
+        shallowReadonly(reactive([{ id: 1 }])),
+        shallowReadonly(shallowReactive([{ id: 1 }]))
+      ]
+      for (const arr of cases) {
+        expect(arr.map(value => value)[0]).toBe(arr[0])
+        expect(arr.find(() => true)).toBe(arr[0])
+      }
+    })
+  })
+
   test('delete on Array should not trigger length dependency', () => {
     const arr = reactive([1, 2, 3])
     const fn = jest.fn()
@@ -9,7 +9,13 @@ import {
   isReactive
 } from '../src/index'
 import { computed } from '@vue/runtime-dom'
-import { shallowRef, unref, customRef, triggerRef } from '../src/ref'
+import {
+  shallowRef,
+  unref,
+  customRef,
+  triggerRef,
+  listRef
+} from '../src/ref'
 import { isShallow } from '../src/reactive'
 
 describe('reactivity/ref', () => {
@@ -400,4 +406,113 @@ describe('reactivity/ref', () => {
     b.value = obj
     expect(spy2).toBeCalledTimes(1)
   })
+
+  describe('listRef', () => {
+    const rows = (labels: string[]) =>
+      labels.map((label, id) => ({ id, label }))
+
+    it('should update the array in place with changed rows only', () => {
+      const list = listRef(rows(['a', 'b', 'c']), { key: 'id' })
+      const array = list.value
+      const [a, b, c] = array
+      expect(isReactive(array)).toBe(true)
+      expect(isReactive(array[0])).toBe(false)
+
+      list.value = rows(['a', 'B', 'c'])
+      expect(list.value).toBe(array)
+      expect(array.map(r => r.label)).toEqual(['a', 'B', 'c'])
+      // unchanged rows keep their previous object
+      expect(array[0]).toBe(a)
+      expect(array[1]).not.toBe(b)
+      expect(array[2]).toBe(c)
+    })
+
+    it('should only trigger effects of indices holding a different item', () => {
+      const list = listRef(rows(['a', 'b', 'c']), { key: 'id' })
+      const spies = [0, 1, 2].map(i => {
+        const spy = jest.fn(() => list.value[i])
+        effect(spy)
+        return spy
+      })
+      const lengthSpy = jest.fn(() => list.value.length)
+      effect(lengthSpy)
+
+      list.value = rows(['a', 'B', 'c'])
+      expect(spies.map(spy => spy.mock.calls.length)).toEqual([1, 2, 1])
+      expect(lengthSpy).toHaveBeenCalledTimes(1)
+
+      // same content: nothing is triggered
+      list.value = rows(['a', 'B', 'c'])
+      expect(spies.map(spy => spy.mock.calls.length)).toEqual([1, 2, 1])
+      expect(lengthSpy).toHaveBeenCalledTimes(1)
+    })
+
+    it('should trigger the ref when the length changes', () => {
+      const list = listRef(rows(['a', 'b', 'c']), { key: 'id' })
+      const spy = jest.fn(() => list.value[0])
+      effect(spy)
+      const getter = jest.fn(() => list.value)
+      const c = computed(getter)
+      effect(() => c.value)
+
+      list.value = rows(['a', 'B', 'c'])
+      expect(spy).toHaveBeenCalledTimes(1)
+      expect(getter).toHaveBeenCalledTimes(1)
+
+      list.value = rows(['a', 'B'])
+      expect(spy).toHaveBeenCalledTimes(2)
+      expect(getter).toHaveBeenCalledTimes(2)
+      expect(c.value).toBe(list.value)
+    })
+
+    it('should run an effect reading the whole list once per update', () => {
+      const list = listRef(rows(['a', 'b', 'c']), { key: 'id' })
+      let labels: string[] = []
+      const spy = jest.fn(() => {
+        labels = list.value.map(r => r.label)
+      })
+      effect(spy)
+
+      list.value = rows(['A', 'B', 'C', 'D'])
+      expect(spy).toHaveBeenCalledTimes(2)
+      expect(labels).toEqual(['A', 'B', 'C', 'D'])
+    })
+
+    it('should reuse moved items by key', () => {
+      const list = listRef(rows(['a', 'b']), { key: r => r.id })
+      const [a, b] = list.value
+      list.value = [
+        { id: 1, label: 'b' },
+        { id: 0, label: 'a' }
+      ]
+      expect(list.value[0]).toBe(b)
+      expect(list.value[1]).toBe(a)
+    })
+
+    it('should match items by index without a key', () => {
+      const list = listRef([1, 2, 3])
+      const spy = jest.fn(() => list.value[0])
+      effect(spy)
+      list.value = [1, 5, 3]
+      expect(list.value).toEqual([1, 5, 3])
+      expect(spy).toHaveBeenCalledTimes(1)
+    })
+
+    it('should use a custom isEqual', () => {
+      const list = listRef(rows(['a']), {
+        key: 'id',
+        isEqual: (a, b) => a.label.toLowerCase() === b.label.toLowerCase()
+      })
+      const [a] = list.value
+      list.value = rows(['A'])
+      expect(list.value[0]).toBe(a)
+    })
+
+    it('should be a shallow ref', () => {
+      const list = listRef<number>()
+      expect(isRef(list)).toBe(true)
+      expect(isShallow(list)).toBe(true)
+      expect(list.value).toEqual([])
+    })
+  })
 })
@@ -83,6 +83,21 @@ describe('shallowReactive', () => {
       expect(isReactive(spreadA)).toBe(false)
     })
 
+    test('should track iteration of a shallow Map', () => {
+      const shallowMap = shallowReactive(new Map<string, object>())
+      const a = {}
+      let entries: [string, object][] = []
+      effect(() => {
+        entries = [...shallowMap]
+      })
+      expect(entries).toEqual([])
+
+      shallowMap.set('a', a)
+      expect(entries.length).toBe(1)
+      expect(entries[0][1]).toBe(a)
+      expect(isReactive(entries[0][1])).toBe(false)
+    })
+
     test('should not get reactive entry', () => {
       const shallowMap = shallowReactive(new Map())
       const a = {}
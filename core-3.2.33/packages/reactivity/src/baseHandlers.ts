@@ -9,13 +9,16 @@ import {
   shallowReactiveMap,
   shallowReadonlyMap,
   isReadonly,
-  isShallow
+  isShallow,
+  toReactive,
+  toReadonly
 } from './reactive'
 import { TrackOpTypes, TriggerOpTypes } from './operations'
 import {
   track,
   trigger,
   ITERATE_KEY,
+  ARRAY_ITERATE_KEY,
   pauseTracking,
   resetTracking
 } from './effect'
@@ -49,6 +52,24 @@ const shallowGet = /*#__PURE__*/ createGetter(false, true)
 const readonlyGet = /*#__PURE__*/ createGetter(true)
 const shallowReadonlyGet = /*#__PURE__*/ createGetter(true, true)
 
+const identity = (value: unknown) => value
+
+// Returns how the instrumented iteration methods wrap a raw element, so that
+// callbacks receive the same value as `proxy[index]`. Readonly arrays are not
+// instrumented, so a readonly `proxy` always wraps a reactive array, e.g.
+// `readonly(reactive(arr))`.
+function getItemWrapper(proxy: unknown[]): (value: unknown) => unknown {
+  if (isReadonly(proxy)) {
+    const wrapInner = getItemWrapper((proxy as Target)[ReactiveFlags.RAW])
+    return isShallow(proxy)
+      ? wrapInner
+      : wrapInner === identity
+      ? toReadonly
+      : (value: unknown) => toReadonly(wrapInner(value))
+  }
+  return isShallow(proxy) ? identity : toReactive
+}
+
 const arrayInstrumentations = /*#__PURE__*/ createArrayInstrumentations()
 
 //返回一个对象，对象内保存了若干个被特殊处理的数组方法，并以键值对的形式存储。
@@ -61,10 +82,8 @@ function createArrayInstrumentations() {
   ;(['includes', 'indexOf', 'lastIndexOf'] as const).forEach(key => {
     instrumentations[key] = function (this: unknown[], ...args: unknown[]) {
       const arr = toRaw(this) as any
-      //对数组的每一项进行依赖收集
-      for (let i = 0, l = this.length; i < l; i++) {
-        track(arr, TrackOpTypes.GET, i + '')
-      }
+      //对整个数组进行一次依赖收集，而不是每一项
+      track(arr, TrackOpTypes.ITERATE, ARRAY_ITERATE_KEY)
       // we run the method using the original args first (which may be reactive)
       const res = arr[key](...args)
       if (res === -1 || res === false) {
@@ -75,6 +94,63 @@ function createArrayInstrumentations() {
       }
     }
   })
+  // iteration methods also track the whole array once and run on the raw
+  // array, wrapping only the elements passed to the callback
+  ;(
+    ['every', 'filter', 'find', 'findIndex', 'forEach', 'map', 'some'] as const
+  ).forEach(key => {
+    instrumentations[key] = function (
+      this: unknown[],
+      fn: (item: unknown, index: number, array: unknown[]) => unknown,
+      thisArg?: unknown
+    ) {
+      const arr = toRaw(this) as any
+      // respect methods overridden by array subclasses
+      if (arr[key] !== Array.prototype[key]) {
+        return arr[key].call(this, fn, thisArg)
+      }
+      track(arr, TrackOpTypes.ITERATE, ARRAY_ITERATE_KEY)
+      const wrap = getItemWrapper(this)
+      const res = arr[key]((item: unknown, index: number) => {
+        return fn.call(thisArg, wrap(item), index, this)
+      })
+      return key === 'filter'
+        ? res.map(wrap)
+        : key === 'find'
+        ? wrap(res)
+        : res
+    }
+  })
+  ;(['reduce', 'reduceRight'] as const).forEach(key => {
+    instrumentations[key] = function (
+      this: unknown[],
+      fn: (acc: unknown, item: unknown, index: number, array: unknown[]) => any,
+      ...args: unknown[]
+    ) {
+      const arr = toRaw(this) as any
+      if (arr[key] !== Array.prototype[key]) {
+        return arr[key].call(this, fn, ...args)
+      }
+      track(arr, TrackOpTypes.ITERATE, ARRAY_ITERATE_KEY)
+      const wrap = getItemWrapper(this)
+      // without an initial value the first element is the initial value
+      let wrapAcc = !args.length
+      const res = arr[key]((acc: unknown, item: unknown, index: number) => {
+        if (wrapAcc) {
+          acc = wrap(acc)
+          wrapAcc = false
+        }
+        return fn(acc, wrap(item), index, this)
+      }, ...args)
+      // a single element is returned without calling the callback
+      return wrapAcc ? wrap(res) : res
+    }
+  })
+  instrumentations.join = function (this: unknown[], separator?: string) {
+    const arr = toRaw(this)
+    track(arr, TrackOpTypes.ITERATE, ARRAY_ITERATE_KEY)
+    return arr.join(separator)
+  }
   // instrument length-altering mutation methods to avoid length being tracked
   // which leads to infinite loops in some cases (#2137)
   // length被修改,某些场景会无限循环,比如push方法会访问length
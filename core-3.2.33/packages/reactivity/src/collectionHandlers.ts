@@ -1,4 +1,10 @@
-import { toRaw, ReactiveFlags, toReactive, toReadonly } from './reactive'
+import {
+  toRaw,
+  ReactiveFlags,
+  toReactive,
+  toReadonly,
+  isReactive
+} from './reactive'
 import { track, trigger, ITERATE_KEY, MAP_KEY_ITERATE_KEY } from './effect'
 import { TrackOpTypes, TriggerOpTypes } from './operations'
 import { capitalize, hasOwn, hasChanged, toRawType, isMap } from '@vue/shared'
@@ -194,6 +200,11 @@ function createIterableMethod(
         TrackOpTypes.ITERATE,
         isKeyOnly ? MAP_KEY_ITERATE_KEY : ITERATE_KEY
       )
+    if (isShallow) {
+      // shallow collections yield the values as they are, so there is
+      // nothing to wrap and the real iterator can be returned as is
+      return innerIterator
+    }
     // return a wrapped iterator which returns observed versions of the
     // values emitted from the real iterator
     return {
@@ -215,6 +226,67 @@ function createIterableMethod(
   }
 }
 
+type RawIteratorMethod = 'keys' | 'values' | 'entries'
+
+/**
+ * Iterates a reactive `Map` or `Set` without wrapping each key and value in a
+ * reactive / readonly proxy. The iteration is tracked once, like a regular
+ * iteration of the collection, but the iterator of the raw collection is
+ * returned, so items are yielded as stored (nested objects are not reactive)
+ * and iterating costs the same as iterating the raw collection.
+ *
+ * Defaults to the default iterator of the collection, i.e. `entries` for a
+ * `Map` and `values` for a `Set`.
+ *
+ * @example
+ * ```js
+ * const cache = reactive(new Map())
+ * watchEffect(() => {
+ *   for (const [key, value] of iterateRaw(cache)) {
+ *     // `value` is the raw value, mutating it won't trigger anything
+ *   }
+ * })
+ * ```
+ */
+export function iterateRaw<K, V>(
+  target: Map<K, V>,
+  method?: 'entries'
+): IterableIterator<[K, V]>
+export function iterateRaw<K>(
+  target: Map<K, any>,
+  method: 'keys'
+): IterableIterator<K>
+export function iterateRaw<V>(
+  target: Map<any, V>,
+  method: 'values'
+): IterableIterator<V>
+export function iterateRaw<T>(
+  target: Set<T>,
+  method?: 'keys' | 'values'
+): IterableIterator<T>
+export function iterateRaw<T>(
+  target: Set<T>,
+  method: 'entries'
+): IterableIterator<[T, T]>
+export function iterateRaw(
+  target: IterableCollections,
+  method?: RawIteratorMethod
+): IterableIterator<unknown> {
+  const rawTarget = toRaw(target)
+  const targetIsMap = isMap(rawTarget)
+  // readonly(reactive(Map)) is tracked through the inner reactive collection
+  if (isReactive(target)) {
+    track(
+      rawTarget,
+      TrackOpTypes.ITERATE,
+      method === 'keys' && targetIsMap ? MAP_KEY_ITERATE_KEY : ITERATE_KEY
+    )
+  }
+  return method
+    ? rawTarget[method]()
+    : (rawTarget as any)[Symbol.iterator]()
+}
+
 function createReadonlyMethod(type: TriggerOpTypes): Function {
   return function (this: CollectionTypes, ...args: unknown[]) {
     if (__DEV__) {
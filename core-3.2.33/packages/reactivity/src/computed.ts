@@ -1,8 +1,8 @@
-import { DebuggerOptions, ReactiveEffect } from './effect'
+import { DebuggerOptions, DirtyLevels, ReactiveEffect } from './effect'
 import { Ref, trackRefValue, triggerRefValue } from './ref'
-import { isFunction, NOOP } from '@vue/shared'
+import { hasChanged, isFunction, NOOP } from '@vue/shared'
 import { ReactiveFlags, toRaw } from './reactive'
-import { Dep } from './dep'
+import { createDep, Dep } from './dep'
 
 declare const ComputedRefSymbol: unique symbol
 
@@ -24,7 +24,7 @@ export interface WritableComputedOptions<T> {
 }
 
 export class ComputedRefImpl<T> {
-  public dep?: Dep = undefined
+  public dep: Dep = createDep()
   // 缓存的值
   private _value!: T
   // 在构造器中创建的ReactiveEffect实例
@@ -33,7 +33,7 @@ export class ComputedRefImpl<T> {
   public readonly __v_isRef = true
   // 只读标识
   public readonly [ReactiveFlags.IS_READONLY]: boolean
-  // 是否为脏数据，如果是脏数据需要重新计算
+  // 是否可能为脏数据，如果是需要检查依赖是否变化，变化了才重新计算
   public _dirty = true
   // 是否可缓存，取决于SSR
   public _cacheable: boolean
@@ -50,8 +50,8 @@ export class ComputedRefImpl<T> {
     this.effect = new ReactiveEffect(getter, () => {
       if (!this._dirty) {
         this._dirty = true
-        //触发依赖
-        triggerRefValue(this)
+        // 触发依赖：只通知下游可能需要更新，值是否真的变化在读取时才确定
+        triggerRefValue(this, undefined, DirtyLevels.MaybeDirty)
       }
     })
     // this.effect.computed指向this
@@ -59,6 +59,7 @@ export class ComputedRefImpl<T> {
     // this.effect.active与this._cacheable在SSR中为false
     this.effect.active = this._cacheable = !isSSR
     this[ReactiveFlags.IS_READONLY] = isReadonly
+    this.dep.computed = this
   }
 
   get value() {
@@ -66,21 +67,39 @@ export class ComputedRefImpl<T> {
     // computed可能被其他proxy包裹，如readonly(computed(() => foo.bar))，所以要获取this的原始对象
     //// computed可能被其他proxy包裹，如readonly(computed(() => foo.bar))，所以要获取this的原始对象
     const self = toRaw(this)
+    // 先更新值再收集依赖，使依赖记录的是最新的版本
+    self._refresh()
     //收集依赖
     trackRefValue(self)
-    // 如果是脏数据或者是SSR，需要重新计算
-    if (self._dirty || !self._cacheable) {
-      // _dirty取false，防止依赖不变重复计算
-      self._dirty = false
-      // 计算
-      self._value = self.effect.run()!
-    }
     return self._value
   }
 
   set value(newValue: T) {
     this._setter(newValue)
   }
+
+  /**
+   * Re-evaluates the getter if any of the sources changed, and bumps the
+   * version of the dep when the value changed, so that subscribers notified
+   * as maybe dirty can tell.
+   * @internal
+   */
+  _refresh() {
+    // 如果可能是脏数据或者是SSR，需要检查是否重新计算
+    if (this._dirty || !this._cacheable) {
+      // _dirty取false，防止依赖不变重复计算
+      this._dirty = false
+      // SSR时每次都重新计算，否则只有依赖变化了才重新计算
+      if (!this._cacheable || this.effect.dirty) {
+        const oldValue = this._value
+        // 计算
+        this._value = this.effect.run()!
+        if (hasChanged(oldValue, this._value)) {
+          this.dep.version++
+        }
+      }
+    }
+  }
 }
 
 //接受一个getter函数，并以getter函数的返回值返回一个不可变的响应式ref对象。
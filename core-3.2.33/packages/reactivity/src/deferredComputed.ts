@@ -57,7 +57,8 @@ class DeferredComputedRefImpl<T> {
         // chained upstream computeds are notified synchronously to ensure
         // value invalidation in case of sync access; normal effects are
         // deferred to be triggered in scheduler.
-        for (const e of this.dep) {
+        for (let link = this.dep.subsHead; link; link = link.nextSub) {
+          const e = link.sub
           if (e.computed instanceof DeferredComputedRefImpl) {
             e.scheduler!(true /* computedTrigger */)
           }
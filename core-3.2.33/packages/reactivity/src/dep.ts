@@ -1,63 +1,147 @@
-import { ReactiveEffect, trackOpBit } from './effect'
+import type { ReactiveEffect } from './effect'
+import type { ComputedRefImpl } from './computed'
 
-export type Dep = Set<ReactiveEffect> & TrackedMarkers
+/**
+ * A reactive dependency, e.g. a property of a reactive object or the value
+ * of a ref. Instead of a Set of effects, the subscribers are kept in a
+ * doubly-linked list of `Link` nodes, which are shared with the effect's own
+ * list of deps. Tracking and cleanup therefore only ever allocate the link
+ * itself.
+ */
+export class Dep {
+  /**
+   * Incremented every time the dep is triggered. For the dep of a computed,
+   * only incremented when its value actually changes.
+   */
+  version = 0
+  /**
+   * Link between this dep and the innermost running effect that has tracked
+   * it, so tracking the same dep repeatedly during a run is O(1).
+   */
+  activeLink?: Link = undefined
+  /**
+   * Head and tail of the subscriber list, in subscription order.
+   */
+  subsHead?: Link = undefined
+  subsTail?: Link = undefined
+  /**
+   * The computed this dep belongs to, re-evaluated by subscribers that need
+   * to know whether it changed (see `ReactiveEffect.dirty`).
+   */
+  computed?: ComputedRefImpl<any> = undefined
+
+  /**
+   * For deps of reactive object properties: the `KeyToDepMap` of the target
+   * and the key this dep is stored under, so that the dep can be removed
+   * from it once it has no subscribers left.
+   */
+  constructor(public map?: Map<any, Dep>, public key?: unknown) {}
+}
 
 /**
- * wasTracked and newTracked maintain the status for several levels of effect
- * tracking recursion. One bit per level is used to define whether the dependency
- * was/is tracked.
+ * Connects an effect to one of its deps. Each link is a node in two
+ * doubly-linked lists at once: the deps of the effect (`prevDep`/`nextDep`)
+ * and the subscribers of the dep (`prevSub`/`nextSub`).
  */
-type TrackedMarkers = {
+export class Link {
   /**
-   * wasTracked 表示是否已经被收集
+   * `dep.version` when the dep was last tracked, or -1 while the effect is
+   * running and has not accessed the dep yet. Links still at -1 when the run
+   * finishes are no longer needed and get removed.
    */
-  w: number
+  version: number
+  prevDep?: Link = undefined
+  nextDep?: Link = undefined
+  prevSub?: Link = undefined
+  nextSub?: Link = undefined
   /**
-   * newTracked 表示是否新收集
+   * The `dep.activeLink` to restore once the effect finishes running.
    */
-  n: number
+  prevActiveLink?: Link = undefined
+
+  constructor(public sub: ReactiveEffect, public dep: Dep) {
+    this.version = dep.version
+  }
 }
 
-export const createDep = (effects?: ReactiveEffect[]): Dep => {
-  const dep = new Set<ReactiveEffect>(effects) as Dep
-  dep.w = 0
-  dep.n = 0
-  return dep
+export const createDep = (map?: Map<any, Dep>, key?: unknown): Dep =>
+  new Dep(map, key)
+
+/**
+ * Creates a link between the running effect and a dep it hasn't tracked
+ * before, appending it to both lists.
+ */
+export function addLink(effect: ReactiveEffect, dep: Dep): Link {
+  const link = new Link(effect, dep)
+
+  link.prevDep = effect.depsTail
+  if (effect.depsTail) {
+    effect.depsTail.nextDep = link
+  } else {
+    effect.deps = link
+  }
+  effect.depsTail = link
+
+  link.prevSub = dep.subsTail
+  if (dep.subsTail) {
+    dep.subsTail.nextSub = link
+  } else {
+    dep.subsHead = link
+  }
+  dep.subsTail = link
+
+  link.prevActiveLink = dep.activeLink
+  dep.activeLink = link
+  return link
 }
-// wasTracked(dep)返回true，意味着dep在之前的依赖收集过程中已经被收集过，或者说在之前run执行过程中已经被收集
-export const wasTracked = (dep: Dep): boolean => (dep.w & trackOpBit) > 0
-// newTracked(dep)返回true，意味着dep是在本次依赖收集过程中新收集到的，或者说在本次run执行过程中新收集到的
-export const newTracked = (dep: Dep): boolean => (dep.n & trackOpBit) > 0
 
-export const initDepMarkers = ({ deps }: ReactiveEffect) => {
-  if (deps.length) {
-    for (let i = 0; i < deps.length; i++) {
-      deps[i].w |= trackOpBit // set was tracked
+/**
+ * Moves a link tracked again during a run to the end of the effect's deps,
+ * so that the deps stay in the order they were last accessed.
+ */
+export function moveLinkToTail(link: Link) {
+  const { sub, prevDep, nextDep } = link
+  if (nextDep) {
+    nextDep.prevDep = prevDep
+    if (prevDep) {
+      prevDep.nextDep = nextDep
+    } else {
+      sub.deps = nextDep
     }
+    link.prevDep = sub.depsTail
+    link.nextDep = undefined
+    sub.depsTail!.nextDep = link
+    sub.depsTail = link
   }
 }
 
-//找到那些曾经被收集过但是新的一轮依赖收集没有被收集的依赖，从 deps 中移除。
-// 其实就是解决需要 cleanup 场景的问题：
-// 在新的组件渲染过程中没有访问到的响应式对象，那么它的变化不应该触发组件的重新渲染。
-export const finalizeDepMarkers = (effect: ReactiveEffect) => {
-  const { deps } = effect
-  if (deps.length) {
-    let ptr = 0
-    for (let i = 0; i < deps.length; i++) {
-      const dep = deps[i]
-      // 曾经被收集过但不是新的依赖，需要删除
-      if (wasTracked(dep) && !newTracked(dep)) {
-        dep.delete(effect)
-      } else {
-        deps[ptr++] = dep
-      }
-      // clear bits
-      // 清空状态
-      dep.w &= ~trackOpBit
-      dep.n &= ~trackOpBit
-    }
-    deps.length = ptr
+function removeLink(link: Link) {
+  const { sub, dep, prevDep, nextDep, prevSub, nextSub } = link
+  if (prevDep) {
+    prevDep.nextDep = nextDep
+  } else {
+    sub.deps = nextDep
+  }
+  if (nextDep) {
+    nextDep.prevDep = prevDep
+  } else {
+    sub.depsTail = prevDep
+  }
+  if (prevSub) {
+    prevSub.nextSub = nextSub
+  } else {
+    dep.subsHead = nextSub
+  }
+  if (nextSub) {
+    nextSub.prevSub = prevSub
+  } else {
+    dep.subsTail = prevSub
+  }
+  link.prevDep = link.nextDep = link.prevSub = link.nextSub = undefined
+  // the last subscriber is gone: drop the dep, otherwise targets with
+  // churning keys keep one dep per key they have ever had
+  if (!dep.subsHead && dep.map) {
+    dep.map.delete(dep.key)
   }
 }
 
@@ -65,4 +149,49 @@ export const finalizeDepMarkers = (effect: ReactiveEffect) => {
 // 现在的实现会在每次执行 effect 包裹的函数前标记依赖的状态，
 // 过程中对于已经收集的依赖不会重复收集，
 // 执行完 effect 函数还会移除掉已被收集但是新的一轮依赖收集中没有被收集的依赖。
-// 优化后对于 dep 依赖集合的操作减少了，自然也就优化了性能。
+/**
+ * Called before an effect runs: marks all of its links as unused and makes
+ * them the active links of their deps.
+ */
+export function prepareDeps(effect: ReactiveEffect) {
+  for (let link = effect.deps; link; link = link.nextDep) {
+    link.version = -1
+    link.prevActiveLink = link.dep.activeLink
+    link.dep.activeLink = link
+  }
+}
+
+//找到那些曾经被收集过但是新的一轮依赖收集没有被收集的依赖，从 deps 中移除。
+// 其实就是解决需要 cleanup 场景的问题：
+// 在新的组件渲染过程中没有访问到的响应式对象，那么它的变化不应该触发组件的重新渲染。
+/**
+ * Called after an effect runs: removes the links that were not tracked
+ * during the run and restores the previous active links.
+ */
+export function cleanupDeps(effect: ReactiveEffect) {
+  let link = effect.deps
+  while (link) {
+    const next = link.nextDep
+    link.dep.activeLink = link.prevActiveLink
+    link.prevActiveLink = undefined
+    if (link.version === -1) {
+      removeLink(link)
+    }
+    link = next
+  }
+}
+
+/**
+ * Removes all links of an effect, e.g. when it is stopped.
+ */
+export function cleanupEffect(effect: ReactiveEffect) {
+  let link = effect.deps
+  while (link) {
+    const next = link.nextDep
+    if (link.dep.activeLink === link) {
+      link.dep.activeLink = link.prevActiveLink
+    }
+    removeLink(link)
+    link = next
+  }
+}
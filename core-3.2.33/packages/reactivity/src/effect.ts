@@ -2,38 +2,48 @@ import { TrackOpTypes, TriggerOpTypes } from './operations'
 import { extend, isArray, isIntegerKey, isMap } from '@vue/shared'
 import { EffectScope, recordEffectScope } from './effectScope'
 import {
+  addLink,
+  cleanupDeps,
+  cleanupEffect,
   createDep,
   Dep,
-  finalizeDepMarkers,
-  initDepMarkers,
-  newTracked,
-  wasTracked
+  Link,
+  moveLinkToTail,
+  prepareDeps
 } from './dep'
 import { ComputedRefImpl } from './computed'
+import {
+  endRun,
+  profiling,
+  recordTrigger,
+  setTriggerSource,
+  startRun,
+  takeTriggerSource
+} from './profiler'
 
 // The main WeakMap that stores {target -> key -> dep} connections.
-// Conceptually, it's easier to think of a dependency as a Dep class
-// which maintains a Set of subscribers, but we simply store them as
-// raw Sets to reduce memory overhead.
+// Each Dep keeps its subscribers in a linked list of Link nodes that are
+// shared with the subscribing effects' lists of deps (see dep.ts), and
+// removes itself from its KeyToDepMap once the list is empty.
 type KeyToDepMap = Map<any, Dep>
 const targetMap = new WeakMap<any, KeyToDepMap>()
 
-// The number of effects currently being tracked recursively.
-//  表示递归嵌套执行  effect 函数的深度
-let effectTrackDepth = 0
-// 用于标识依赖收集的状态
-export let trackOpBit = 1
+// Used to collect each effect only once when triggering several deps.
+let triggerId = 0
 
-/**
- * The bitwise track markers support at most 30 levels of recursion.
- * This value is chosen to enable modern JS engines to use a SMI on all platforms.
- * When recursion depth is greater, fall back to using a full cleanup.
- */
-//  表示最大标记的位数
-const maxMarkerBits = 30
+// Effects triggered during a batch, run once the outermost batch ends.
+let batchDepth = 0
+let batchedEffects: ReactiveEffect[] = []
 
 export type EffectScheduler = (...args: any[]) => any
 
+export const enum DirtyLevels {
+  NotDirty = 0,
+  // notified by a computed, which may or may not have changed value
+  MaybeDirty = 1,
+  Dirty = 2
+}
+
 export type DebuggerEvent = {
   effect: ReactiveEffect
 } & DebuggerEventExtraInfo
@@ -51,10 +61,21 @@ export let activeEffect: ReactiveEffect | undefined
 
 export const ITERATE_KEY = Symbol(__DEV__ ? 'iterate' : '')
 export const MAP_KEY_ITERATE_KEY = Symbol(__DEV__ ? 'Map key iterate' : '')
+// tracked by array search and iteration methods instead of every index
+export const ARRAY_ITERATE_KEY = Symbol(__DEV__ ? 'Array iterate' : '')
 
 export class ReactiveEffect<T = any> {
   active = true //是否激活
-  deps: Dep[] = [] //effect对应的属性
+  /**
+   * Head of the linked list of deps tracked by this effect
+   * @internal
+   */
+  deps?: Link = undefined //effect对应的属性
+  /**
+   * Tail of the linked list of deps
+   * @internal
+   */
+  depsTail?: Link = undefined
   parent: ReactiveEffect | undefined = undefined
 
   /**
@@ -70,6 +91,24 @@ export class ReactiveEffect<T = any> {
    * @internal
    */
   private deferStop?: boolean
+  /**
+   * Whether the effect is somewhere in the stack of running effects
+   * @internal
+   */
+  _running = false
+  /**
+   * @internal
+   */
+  _dirtyLevel = DirtyLevels.Dirty
+  /**
+   * Whether the effect is queued to run at the end of the current batch
+   * @internal
+   */
+  _batched = false
+  /**
+   * @internal
+   */
+  _triggerId = 0
 
   onStop?: () => void
   // dev only
@@ -87,57 +126,68 @@ export class ReactiveEffect<T = any> {
     recordEffectScope(this, scope)
   }
 
+  /**
+   * Whether the effect needs to re-run since it last ran. An effect notified
+   * only by computeds is dirty if one of them has actually changed value,
+   * which is checked by re-evaluating them.
+   */
+  get dirty(): boolean {
+    if (this._dirtyLevel === DirtyLevels.MaybeDirty) {
+      this._dirtyLevel = DirtyLevels.NotDirty
+      for (let link = this.deps; link; link = link.nextDep) {
+        const { dep } = link
+        if (dep.computed) {
+          dep.computed._refresh()
+        }
+        if (dep.version !== link.version) {
+          this._dirtyLevel = DirtyLevels.Dirty
+          break
+        }
+      }
+    }
+    return this._dirtyLevel === DirtyLevels.Dirty
+  }
+
+  set dirty(v: boolean) {
+    this._dirtyLevel = v ? DirtyLevels.Dirty : DirtyLevels.NotDirty
+  }
+
   run() {
     //首先判断ReactiveEffect的激活状态（active），如果未激活（this.active === false），那么会立马执行this.fn并返回他的执行结果
     if (!this.active) {
       return this.fn()
     }
-    let parent: ReactiveEffect | undefined = activeEffect
-    let lastShouldTrack = shouldTrack
-    // 使用while循环寻找parent.parent，一旦parent与this相等，立即结束循环。
-    while (parent) {
-      if (parent === this) {
-        return
-      }
-      parent = parent.parent
+    // 已经在effect栈中（parent链上）时直接返回，避免无限递归。
+    // 使用标记而不是遍历parent链，使得检查的开销与嵌套深度无关。
+    if (this._running) {
+      return
     }
+    let lastShouldTrack = shouldTrack
+    this._dirtyLevel = DirtyLevels.NotDirty
+    const profileStart = profiling ? startRun() : -1
 
     try {
       // 建立一个嵌套effect的关系
+      this._running = true
       this.parent = activeEffect
       activeEffect = this
       shouldTrack = true
 
-      // effectTrackDepth是个全局变量为effect的深度，层数从1开始计数，
-      // trackOpBit使用二进制标记依赖收集的状态（如00000000000000000000000000000010表示所处深度为1）
-      trackOpBit = 1 << ++effectTrackDepth
-
-      // 如果effectTrackDepth未超出最大标记位（maxMarkerBits = 30），
-      // 会调用initDepMarkers方法将this.deps中的所有dep标记为已经被track的状态；
-      // 否则使用cleanupEffect移除deps中的所有dep。
-
-      //标记dep为已被track或移除dep的作用就是移除多余的依赖,比如三目运算造成的分支切换
-      // 超过 maxMarkerBits 则 trackOpBit 的计算会超过最大整形的位数，降级为 cleanupEffect
-      if (effectTrackDepth <= maxMarkerBits) {
-        // 将依赖标记为已收集
-        initDepMarkers(this)
-      } else {
-        cleanupEffect(this)
-      }
+      //标记dep为未使用,运行结束后移除多余的依赖,比如三目运算造成的分支切换
+      prepareDeps(this)
       return this.fn()
     } finally {
-      //根据一些状态移除多余的依赖、将effectTrackDepth回退一层，
-      // activeEffect指向当前ReactiveEffect的parent、shouldTrack = lastShouldTrack、this.parent置为undefined
-      if (effectTrackDepth <= maxMarkerBits) {
-        // 完成依赖标记
-        finalizeDepMarkers(this)
-      }
-      // 恢复到上一级
-      trackOpBit = 1 << --effectTrackDepth
+      // 移除多余的依赖，activeEffect指向当前ReactiveEffect的parent、
+      // shouldTrack = lastShouldTrack、this.parent置为undefined
+      cleanupDeps(this)
 
       activeEffect = this.parent
       shouldTrack = lastShouldTrack
       this.parent = undefined
+      this._running = false
+      if (profileStart !== -1) {
+        endRun(this, profileStart)
+      }
 
       if (this.deferStop) {
         this.stop()
@@ -159,17 +209,6 @@ export class ReactiveEffect<T = any> {
   }
 }
 
-// 清除依赖
-function cleanupEffect(effect: ReactiveEffect) {
-  const { deps } = effect
-  if (deps.length) {
-    for (let i = 0; i < deps.length; i++) {
-      deps[i].delete(effect)
-    }
-    deps.length = 0
-  }
-}
-
 export interface DebuggerOptions {
   onTrack?: (event: DebuggerEvent) => void
   onTrigger?: (event: DebuggerEvent) => void
@@ -257,7 +296,7 @@ export function track(target: object, type: TrackOpTypes, key: unknown) {
     }
     let dep = depsMap.get(key)
     if (!dep) {
-      depsMap.set(key, (dep = createDep()))
+      depsMap.set(key, (dep = createDep(depsMap, key)))
     }
 
     const eventInfo = __DEV__
@@ -268,40 +307,33 @@ export function track(target: object, type: TrackOpTypes, key: unknown) {
   }
 }
 
+// for tests: the dep of a target's key, if any effect currently tracks it
+export function getDepFromReactive(target: object, key: unknown) {
+  const depsMap = targetMap.get(target)
+  return depsMap && depsMap.get(key)
+}
+
 export function trackEffects(
   dep: Dep,
   debuggerEventExtraInfo?: DebuggerEventExtraInfo
 ) {
-  let shouldTrack = false
-  if (effectTrackDepth <= maxMarkerBits) {
-    //根据tracked标识判断是否进行依赖收集
-
-    // 如果newTracked(dep) === true，说明在本次run方法执行过程中，dep已经被收集过了，shouldTrack不变；
-    // 如果newTracked(dep) === false，要把dep标记为新收集的，虽然dep在本次收集过程中是新收集的，
-    // 但它可能在之前的收集过程中已经被收集了，所以shouldTrack的值取决于dep是否在之前已经被收集过了。
-
-    if (!newTracked(dep)) {
-      // 标记为新依赖
-      dep.n |= trackOpBit // set newly tracked
-      // 如果依赖已经被收集，则不需要再次收集
-      shouldTrack = !wasTracked(dep)
-    }
-  } else {
-    // Full cleanup mode.
-    // cleanup 模式 判断dep中是否含有activeEffect
-    shouldTrack = !dep.has(activeEffect!)
-  }
-
-  //将activeEffect添加到dep中，同时将dep放入activeEffect.deps中
-  if (shouldTrack) {
-    dep.add(activeEffect!)
-    activeEffect!.deps.push(dep)
-    if (__DEV__ && activeEffect!.onTrack) {
-      activeEffect!.onTrack({
-        effect: activeEffect!,
+  const effect = activeEffect!
+  let link = dep.activeLink
+  if (link === undefined || link.sub !== effect) {
+    // 新的依赖，将effect和dep通过link互相关联
+    addLink(effect, dep)
+    if (__DEV__ && effect.onTrack) {
+      effect.onTrack({
+        effect,
         ...debuggerEventExtraInfo!
       })
     }
+  } else if (link.version === -1) {
+    // 之前已经被收集过，本次run中再次被访问，标记为仍在使用
+    link.version = dep.version
+    // keep the deps in access order, so computeds are re-evaluated by the
+    // dirty check in the same order as they are read
+    moveLinkToTail(link)
   }
 }
 
@@ -339,7 +371,11 @@ export function trigger(
     deps = [...depsMap.values()]
   } else if (key === 'length' && isArray(target)) {
     depsMap.forEach((dep, key) => {
-      if (key === 'length' || key >= (newValue as number)) {
+      if (
+        key === 'length' ||
+        key === ARRAY_ITERATE_KEY ||
+        key >= (newValue as number)
+      ) {
         deps.push(dep)
       }
     })
@@ -348,6 +384,10 @@ export function trigger(
     if (key !== void 0) {
       deps.push(depsMap.get(key))
     }
+    // any change of an element affects whole-array iteration
+    if (isArray(target) && isIntegerKey(key)) {
+      deps.push(depsMap.get(ARRAY_ITERATE_KEY))
+    }
 
     // also run for iteration key on ADD | DELETE | Map.SET
     switch (type) {
@@ -382,6 +422,9 @@ export function trigger(
     ? { target, type, key, newValue, oldValue, oldTarget }
     : undefined
 
+  if (profiling) {
+    setTriggerSource(target, key)
+  }
   if (deps.length === 1) {
     if (deps[0]) {
       if (__DEV__) {
@@ -392,34 +435,145 @@ export function trigger(
     }
   } else {
     const effects: ReactiveEffect[] = []
+    const id = ++triggerId
     for (const dep of deps) {
       if (dep) {
-        effects.push(...dep)
+        dep.version++
+        collectEffects(dep, effects, id)
       }
     }
     if (__DEV__) {
-      triggerEffects(createDep(effects), eventInfo)
+      triggerEffects(effects, eventInfo)
     } else {
-      triggerEffects(createDep(effects))
+      triggerEffects(effects)
+    }
+  }
+}
+
+// collects the subscribers of the dep, skipping effects that were already
+// collected for the same trigger id.
+function collectEffects(dep: Dep, effects: ReactiveEffect[], id: number) {
+  for (let link = dep.subsHead; link; link = link.nextSub) {
+    const effect = link.sub
+    if (effect._triggerId !== id) {
+      effect._triggerId = id
+      effects.push(effect)
     }
   }
 }
 
 export function triggerEffects(
   dep: Dep | ReactiveEffect[],
-  debuggerEventExtraInfo?: DebuggerEventExtraInfo
+  debuggerEventExtraInfo?: DebuggerEventExtraInfo,
+  dirtyLevel = DirtyLevels.Dirty
 ) {
-  // spread into array for stabilization
-  for (const effect of isArray(dep) ? dep : [...dep]) {
+  // collect into an array for stabilization, as running the effects may
+  // modify the subscriber list
+  let effects: ReactiveEffect[]
+  if (isArray(dep)) {
+    effects = dep
+  } else {
+    // a computed notifying that it may have changed leaves its version as is
+    if (dirtyLevel === DirtyLevels.Dirty) {
+      dep.version++
+    }
+    collectEffects(dep, (effects = []), ++triggerId)
+  }
+  const profileSource = profiling ? takeTriggerSource() : undefined
+  for (const effect of effects) {
     if (effect !== activeEffect || effect.allowRecurse) {
+      if (effect._dirtyLevel < dirtyLevel) {
+        effect._dirtyLevel = dirtyLevel
+      }
+      if (profiling) {
+        recordTrigger(effect, profileSource)
+      }
       if (__DEV__ && effect.onTrigger) {
         effect.onTrigger(extend({ effect }, debuggerEventExtraInfo))
       }
-      if (effect.scheduler) {
-        effect.scheduler()
+      // computeds are still notified right away, so that reading them
+      // during the batch gives up-to-date values
+      if (batchDepth > 0 && !effect.computed) {
+        if (!effect._batched) {
+          effect._batched = true
+          batchedEffects.push(effect)
+        }
       } else {
-        effect.run()
+        runTriggeredEffect(effect)
       }
     }
   }
 }
+
+// effects with a scheduler check `effect.dirty` when their job runs
+function runTriggeredEffect(effect: ReactiveEffect) {
+  if (effect.scheduler) {
+    effect.scheduler()
+  } else if (effect.dirty) {
+    effect.run()
+  }
+}
+
+/**
+ * Starts a batch: effects triggered until the matching `endBatch()` call are
+ * deduped and only run (or scheduled) once, when the outermost batch ends.
+ */
+export function startBatch() {
+  batchDepth++
+}
+
+/**
+ * Ends a batch started with `startBatch()`, running the effects triggered
+ * during the batch if it is the outermost one.
+ */
+export function endBatch() {
+  if (--batchDepth > 0) {
+    return
+  }
+  let error: unknown
+  let hasError = false
+  while (batchedEffects.length) {
+    // effects may start new batches while running
+    const effects = batchedEffects
+    batchedEffects = []
+    for (let i = 0; i < effects.length; i++) {
+      const effect = effects[i]
+      effect._batched = false
+      // stopped during the batch
+      if (!effect.active) {
+        continue
+      }
+      try {
+        runTriggeredEffect(effect)
+      } catch (e) {
+        // keep running the other effects, throw the first error afterwards
+        if (!hasError) {
+          error = e
+          hasError = true
+        }
+      }
+    }
+  }
+  if (hasError) {
+    throw error
+  }
+}
+
+/**
+ * Runs `fn` in a batch, so that an effect depending on several of the
+ * mutated values runs only once after `fn` returns.
+ *
+ * ```js
+ * batch(() => {
+ *   for (const row of rows) list.push(row)
+ * })
+ * ```
+ */
+export function batch<T>(fn: () => T): T {
+  startBatch()
+  try {
+    return fn()
+  } finally {
+    endBatch()
+  }
+}
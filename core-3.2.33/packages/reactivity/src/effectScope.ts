@@ -83,10 +83,13 @@ export class EffectScope {
       for (i = 0, l = this.cleanups.length; i < l; i++) {
         this.cleanups[i]()
       }
+      this.cleanups.length = 0
       if (this.scopes) {
         for (i = 0, l = this.scopes.length; i < l; i++) {
           this.scopes[i].stop(true)
         }
+        // stopped child scopes must not keep each other alive
+        this.scopes = undefined
       }
       // nested scope, dereference from parent to avoid memory leaks
       if (this.parent && !fromParent) {
@@ -97,6 +100,9 @@ export class EffectScope {
           last.index = this.index!
         }
       }
+      // a stopped scope that is still referenced, e.g. by an unmounted
+      // component instance, should not retain its parent
+      this.parent = undefined
       this.active = false
     }
   }
@@ -8,6 +8,7 @@ export {
   proxyRefs,
   customRef,
   triggerRef,
+  listRef,
   Ref,
   ToRef,
   ToRefs,
@@ -15,7 +16,8 @@ export {
   ShallowRef,
   ShallowUnwrapRef,
   RefUnwrapBailTypes,
-  CustomRefFactory
+  CustomRefFactory,
+  ListRefOptions
 } from './ref'
 export {
   reactive,
@@ -42,6 +44,7 @@ export {
   ComputedSetter
 } from './computed'
 export { deferredComputed } from './deferredComputed'
+export { iterateRaw } from './collectionHandlers'
 export {
   effect,
   stop,
@@ -50,6 +53,9 @@ export {
   enableTracking,
   pauseTracking,
   resetTracking,
+  batch,
+  startBatch,
+  endBatch,
   ITERATE_KEY,
   ReactiveEffect,
   ReactiveEffectRunner,
@@ -59,6 +65,16 @@ export {
   DebuggerEvent,
   DebuggerEventExtraInfo
 } from './effect'
+export {
+  startProfiling,
+  stopProfiling,
+  toChromeTrace,
+  ProfilerOptions,
+  ReactivityProfile,
+  EffectProfile,
+  TriggerSource,
+  TraceEvent
+} from './profiler'
 export {
   effectScope,
   EffectScope,
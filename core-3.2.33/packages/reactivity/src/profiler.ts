@@ -0,0 +1,283 @@
+import { ReactiveEffect } from './effect'
+
+// An opt-in profiler of the reactive graph that also works in production
+// builds: while profiling is off, the hooks in effect.ts and ref.ts cost a
+// single boolean check.
+
+export interface ProfilerOptions {
+  /**
+   * Also record every single run, so the profile can be exported with
+   * `toChromeTrace()`. Memory grows with the number of runs.
+   */
+  trace?: boolean
+}
+
+export interface TriggerSource {
+  /**
+   * The raw reactive object, ref or computed that was mutated
+   */
+  target: object
+  key: unknown
+  count: number
+}
+
+export interface EffectProfile {
+  effect: ReactiveEffect
+  kind: 'effect' | 'computed'
+  name: string
+  runs: number
+  /**
+   * Cumulative run time in ms, including effects run from inside this one,
+   * e.g. the render effects of child components mounted by a parent.
+   */
+  time: number
+  /**
+   * Cumulative run time in ms, excluding nested effect runs
+   */
+  selfTime: number
+  /**
+   * Number of deps tracked when profiling stopped
+   */
+  deps: number
+  /**
+   * Number of times the effect was notified of a change
+   */
+  triggers: number
+  /**
+   * The target / key whose mutations notified the effect the most
+   */
+  topTrigger: TriggerSource | undefined
+}
+
+export interface TraceEvent {
+  name: string
+  cat: string
+  ph: 'X'
+  ts: number
+  dur: number
+  pid: number
+  tid: number
+  args: Record<string, unknown>
+}
+
+export interface ReactivityProfile {
+  /**
+   * Wall time in ms between `startProfiling()` and `stopProfiling()`
+   */
+  duration: number
+  /**
+   * Profiled effects and computeds, sorted by self time
+   */
+  effects: EffectProfile[]
+  /**
+   * Individual runs, only recorded with `{ trace: true }`
+   */
+  events: TraceEvent[] | undefined
+}
+
+interface EffectRecord extends EffectProfile {
+  triggerCounts: Map<object, Map<unknown, number>>
+}
+
+export let profiling = false
+
+let profileStart = 0
+let records = new Map<ReactiveEffect, EffectRecord>()
+// (record, start, duration) of every run, flattened to avoid an object per run
+let runs: (EffectRecord | number)[] | undefined
+// time spent in nested runs, for each effect currently running
+let nestedTime: number[] = []
+let sourceTarget: object | undefined
+let sourceKey: unknown
+
+const now: () => number =
+  typeof performance !== 'undefined' && performance.now
+    ? () => performance.now()
+    : Date.now
+
+/**
+ * Starts recording run counts, run times, dep counts and trigger sources of
+ * every effect and computed. Restarts if already profiling.
+ */
+export function startProfiling(options: ProfilerOptions = {}) {
+  profiling = true
+  profileStart = now()
+  records = new Map()
+  runs = options.trace ? [] : undefined
+  nestedTime = []
+  sourceTarget = sourceKey = undefined
+}
+
+/**
+ * Stops profiling and returns a flat report of the recorded effects.
+ */
+export function stopProfiling(): ReactivityProfile {
+  const duration = now() - profileStart
+  const effects: EffectProfile[] = []
+  records.forEach(record => {
+    let deps = 0
+    for (let link = record.effect.deps; link; link = link.nextDep) {
+      deps++
+    }
+    record.deps = deps
+    record.topTrigger = getTopTrigger(record.triggerCounts)
+    effects.push(toProfile(record))
+  })
+  effects.sort((a, b) => b.selfTime - a.selfTime)
+
+  let events: TraceEvent[] | undefined
+  if (runs) {
+    events = []
+    for (let i = 0; i < runs.length; i += 3) {
+      const record = runs[i] as EffectRecord
+      events.push({
+        name: `${record.kind} ${record.name}`,
+        cat: record.kind,
+        ph: 'X',
+        ts: ((runs[i + 1] as number) - profileStart) * 1000,
+        dur: (runs[i + 2] as number) * 1000,
+        pid: 1,
+        tid: 1,
+        args: { deps: record.deps }
+      })
+    }
+  }
+
+  profiling = false
+  records = new Map()
+  runs = undefined
+  nestedTime = []
+  sourceTarget = sourceKey = undefined
+  return { duration, effects, events }
+}
+
+/**
+ * Converts a profile recorded with `{ trace: true }` to the Trace Event
+ * Format, which can be loaded in the Performance panel of Chrome DevTools or
+ * in Perfetto.
+ */
+export function toChromeTrace(profile: ReactivityProfile): {
+  traceEvents: TraceEvent[]
+} {
+  return { traceEvents: profile.events || [] }
+}
+
+/**
+ * @internal called by `ReactiveEffect.run()` before running the effect
+ */
+export function startRun(): number {
+  nestedTime.push(0)
+  return now()
+}
+
+/**
+ * @internal
+ */
+export function endRun(effect: ReactiveEffect, start: number) {
+  // profiling was restarted or stopped during the run
+  if (!profiling || !nestedTime.length) {
+    return
+  }
+  const time = now() - start
+  const nested = nestedTime.pop()!
+  if (nestedTime.length) {
+    nestedTime[nestedTime.length - 1] += time
+  }
+  const record = getRecord(effect)
+  record.runs++
+  record.time += time
+  record.selfTime += time - nested
+  if (runs) {
+    runs.push(record, start, time)
+  }
+}
+
+/**
+ * @internal called right before the subscribers of a target / key are
+ * notified
+ */
+export function setTriggerSource(target: object, key: unknown) {
+  sourceTarget = target
+  sourceKey = key
+}
+
+/**
+ * @internal reads and resets the source set by `setTriggerSource()`
+ */
+export function takeTriggerSource(): [object, unknown] | undefined {
+  if (sourceTarget) {
+    const source: [object, unknown] = [sourceTarget, sourceKey]
+    sourceTarget = sourceKey = undefined
+    return source
+  }
+}
+
+/**
+ * @internal
+ */
+export function recordTrigger(
+  effect: ReactiveEffect,
+  source: [object, unknown] | undefined
+) {
+  const record = getRecord(effect)
+  record.triggers++
+  if (source) {
+    const [target, key] = source
+    let keyCounts = record.triggerCounts.get(target)
+    if (!keyCounts) {
+      record.triggerCounts.set(target, (keyCounts = new Map()))
+    }
+    keyCounts.set(key, (keyCounts.get(key) || 0) + 1)
+  }
+}
+
+function getRecord(effect: ReactiveEffect): EffectRecord {
+  let record = records.get(effect)
+  if (!record) {
+    records.set(
+      effect,
+      (record = {
+        effect,
+        kind: effect.computed ? 'computed' : 'effect',
+        name: effect.fn.name || '<anonymous>',
+        runs: 0,
+        time: 0,
+        selfTime: 0,
+        deps: 0,
+        triggers: 0,
+        topTrigger: undefined,
+        triggerCounts: new Map()
+      })
+    )
+  }
+  return record
+}
+
+function getTopTrigger(
+  triggerCounts: Map<object, Map<unknown, number>>
+): TriggerSource | undefined {
+  let top: TriggerSource | undefined
+  triggerCounts.forEach((keyCounts, target) => {
+    keyCounts.forEach((count, key) => {
+      if (!top || count > top.count) {
+        top = { target, key, count }
+      }
+    })
+  })
+  return top
+}
+
+function toProfile(record: EffectRecord): EffectProfile {
+  const { effect, kind, name, runs, time, selfTime, deps, triggers } = record
+  return {
+    effect,
+    kind,
+    name,
+    runs,
+    time,
+    selfTime,
+    deps,
+    triggers,
+    topTrigger: record.topTrigger
+  }
+}
@@ -1,15 +1,25 @@
 import {
   activeEffect,
+  DirtyLevels,
+  endBatch,
   shouldTrack,
+  startBatch,
   trackEffects,
   triggerEffects
 } from './effect'
 import { TrackOpTypes, TriggerOpTypes } from './operations'
-import { isArray, hasChanged, IfAny } from '@vue/shared'
-import { isProxy, toRaw, isReactive, toReactive } from './reactive'
+import { isArray, hasChanged, hasOwn, isObject, IfAny } from '@vue/shared'
+import {
+  isProxy,
+  toRaw,
+  isReactive,
+  toReactive,
+  shallowReactive
+} from './reactive'
 import type { ShallowReactiveMarker } from './reactive'
 import { CollectionTypes } from './collectionHandlers'
 import { createDep, Dep } from './dep'
+import { profiling, setTriggerSource } from './profiler'
 
 declare const RefSymbol: unique symbol
 
@@ -45,19 +55,30 @@ export function trackRefValue(ref: RefBase<any>) {
 
 // 可以接受两个值：ref、newVal。
 // 相比于trugger函数,直接从ref属性中就拿到了它所有的依赖且遍历执行，不需要执行trigger函数一些额外的查找逻辑，因此在性能上也得到了提升。
-export function triggerRefValue(ref: RefBase<any>, newVal?: any) {
+export function triggerRefValue(
+  ref: RefBase<any>,
+  newVal?: any,
+  dirtyLevel = DirtyLevels.Dirty
+) {
   // 获取ref的原始对象，如果ref的原始对象中有dep属性，则触发dep中的依赖。
   ref = toRaw(ref)
   if (ref.dep) {
+    if (profiling) {
+      setTriggerSource(ref, 'value')
+    }
     if (__DEV__) {
-      triggerEffects(ref.dep, {
-        target: ref,
-        type: TriggerOpTypes.SET,
-        key: 'value',
-        newValue: newVal
-      })
+      triggerEffects(
+        ref.dep,
+        {
+          target: ref,
+          type: TriggerOpTypes.SET,
+          key: 'value',
+          newValue: newVal
+        },
+        dirtyLevel
+      )
     } else {
-      triggerEffects(ref.dep)
+      triggerEffects(ref.dep, undefined, dirtyLevel)
     }
   }
 }
@@ -194,6 +215,136 @@ export function customRef<T>(factory: CustomRefFactory<T>): Ref<T> {
   return new CustomRefImpl(factory) as any
 }
 
+export interface ListRefOptions<T> {
+  /**
+   * Identifies an item across updates, as a property name or a function.
+   * Without a key, items are matched by index.
+   */
+  key?: (T extends object ? keyof T : never) | ((item: T) => unknown)
+  /**
+   * Whether a new item has the same content as the previous item with the
+   * same key. Defaults to comparing own enumerable properties with
+   * `Object.is`.
+   */
+  isEqual?: (oldItem: T, newItem: T) => boolean
+}
+
+class ListRefImpl<T> {
+  // the shallowReactive array exposed as `.value`, updated in place
+  private readonly _value: T[]
+  private readonly _getKey: ((item: T) => unknown) | undefined
+  private readonly _isEqual: (oldItem: T, newItem: T) => boolean
+
+  public dep?: Dep = undefined
+  public readonly __v_isRef = true
+  public readonly __v_isShallow = true
+
+  constructor(value: readonly T[], options: ListRefOptions<T>) {
+    const { key, isEqual } = options
+    this._value = shallowReactive(value.slice())
+    this._getKey =
+      typeof key === 'function'
+        ? key
+        : key !== undefined
+        ? (item: T) => (item as any)[key]
+        : undefined
+    this._isEqual = isEqual || shallowEqual
+  }
+
+  get value(): T[] {
+    trackRefValue(this)
+    return this._value
+  }
+
+  set value(newList: readonly T[]) {
+    const list = this._value
+    const oldList = toRaw(list)
+    const oldLength = oldList.length
+    const { _getKey: getKey, _isEqual: isEqual } = this
+    let oldByKey: Map<unknown, T> | undefined
+    if (getKey) {
+      oldByKey = new Map()
+      for (let i = 0; i < oldList.length; i++) {
+        oldByKey.set(getKey(oldList[i]), oldList[i])
+      }
+    }
+    // effects reading several changed rows, e.g. the render of the whole
+    // list, run once after all rows are written
+    startBatch()
+    try {
+      for (let i = 0; i < newList.length; i++) {
+        let item = newList[i]
+        const oldItem = oldByKey
+          ? oldByKey.get(getKey!(item))
+          : i < oldList.length
+          ? oldList[i]
+          : undefined
+        // keep the previous object for unchanged content, so that row
+        // components receiving it as a prop skip their update
+        if (oldItem !== undefined && isEqual(oldItem, item)) {
+          item = oldItem
+        }
+        // only rows holding a different item trigger their index
+        if (i >= oldList.length || oldList[i] !== item) {
+          list[i] = item
+        }
+      }
+      if (newList.length < oldList.length) {
+        list.length = newList.length
+      }
+      // the exposed array keeps its identity, so effects depending on the
+      // ref itself are only triggered when rows are added or removed
+      if (newList.length !== oldLength) {
+        triggerRefValue(this, list)
+      }
+    } finally {
+      endBatch()
+    }
+  }
+}
+
+function shallowEqual(a: unknown, b: unknown): boolean {
+  if (Object.is(a, b)) {
+    return true
+  }
+  if (!isObject(a) || !isObject(b) || isArray(a) !== isArray(b)) {
+    return false
+  }
+  const keys = Object.keys(a)
+  if (keys.length !== Object.keys(b).length) {
+    return false
+  }
+  for (let i = 0; i < keys.length; i++) {
+    const key = keys[i]
+    if (!hasOwn(b, key) || !Object.is((a as any)[key], (b as any)[key])) {
+      return false
+    }
+  }
+  return true
+}
+
+/**
+ * A ref holding a shallowReactive array that is updated in place by a keyed
+ * diff whenever a new array is assigned, e.g. a dataset replaced by polling.
+ * Items whose content did not change keep their previous object, and only
+ * the indices that now hold a different item (plus `length`) are triggered,
+ * so effects reading single rows only re-run for the rows that changed.
+ * The ref itself is triggered when the length of the list changes; to watch
+ * rows replaced in place as well, watch the array (`watch(rows.value, ...)`).
+ *
+ * @example
+ * ```js
+ * const rows = listRef([], { key: 'id' })
+ * rows.value = await fetchRows() // only changed rows are patched
+ * ```
+ */
+export function listRef<T>(
+  value: readonly T[] = [],
+  options: ListRefOptions<T> = {}
+): ShallowRef<T[]> {
+  return new ListRefImpl(value, options) as any
+}
+
 export type ToRefs<T = any> = {
   [K in keyof T]: ToRef<T[K]>
 }
@@ -11,7 +11,8 @@ import {
   Plugin,
   ref,
   getCurrentInstance,
-  defineComponent
+  defineComponent,
+  nextTick
 } from '@vue/runtime-test'
 
 describe('api: createApp', () => {
@@ -482,6 +483,33 @@ describe('api: createApp', () => {
     expect(serializeInner(root)).toBe('hello')
   })
 
+  test('config.timeSlicing', async () => {
+    const calls: string[] = []
+    const count = ref(0)
+    const Child = {
+      props: ['name'],
+      render(this: any) {
+        if (count.value) {
+          calls.push(this.name)
+          // runs in the task before the flush resumes
+          setImmediate(() => calls.push('task'))
+          const start = Date.now()
+          while (Date.now() - start < 2) {}
+        }
+        return count.value
+      }
+    }
+    const app = createApp({
+      render: () => [h(Child, { name: 'a' }), h(Child, { name: 'b' })]
+    })
+    app.config.timeSlicing = 1
+    app.mount(nodeOps.createElement('div'))
+
+    count.value++
+    await nextTick()
+    expect(calls).toEqual(['a', 'task', 'b'])
+  })
+
   test('return property "_" should not overwrite "ctx._", __isScriptSetup: false', () => {
     const Comp = defineComponent({
       setup() {
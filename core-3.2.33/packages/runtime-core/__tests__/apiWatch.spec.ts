@@ -27,6 +27,7 @@ import {
   TriggerOpTypes,
   triggerRef,
   shallowRef,
+  listRef,
   Ref,
   effectScope
 } from '@vue/reactivity'
@@ -865,6 +866,21 @@ describe('api: watch', () => {
     expect(sideEffect).toBe(2)
   })
 
+  test('should trigger when a listRef is replaced with a different length', async () => {
+    const rows = listRef([1, 2])
+    const spy = jest.fn()
+    watch(rows, spy)
+
+    rows.value = [1, 2, 3]
+    await nextTick()
+    expect(spy).toHaveBeenCalledTimes(1)
+    expect(spy.mock.calls[0][0]).toEqual([1, 2, 3])
+
+    rows.value = [4]
+    await nextTick()
+    expect(spy).toHaveBeenCalledTimes(2)
+  })
+
   // #2125
   test('watchEffect should not recursively trigger itself', async () => {
     const spy = jest.fn()
@@ -1090,4 +1106,85 @@ describe('api: watch', () => {
     // own update effect
     expect(instance!.scope.effects.length).toBe(1)
   })
+
+  test('watcher in a lane', async () => {
+    const calls: string[] = []
+    const count = ref(0)
+    const Child = {
+      setup() {
+        watch(count, () => calls.push('idle watcher'), { lane: 'idle' })
+        watch(count, () => calls.push('normal watcher'), { lane: 'normal' })
+        return () => {
+          calls.push('child')
+          return count.value
+        }
+      }
+    }
+    const Sibling = {
+      setup() {
+        watch(count, () => calls.push('sibling idle watcher'), {
+          lane: 'idle'
+        })
+        return () => null
+      }
+    }
+    const Parent = {
+      render() {
+        calls.push('parent')
+        return [count.value, h(Child), h(Sibling)]
+      }
+    }
+    render(h(Parent), nodeOps.createElement('div'))
+    calls.length = 0
+
+    count.value++
+    await nextTick()
+    // runs right before the update of its own component, even from a lower
+    // lane, or after all other lanes if its component is not updated
+    expect(calls).toEqual([
+      'parent',
+      'normal watcher',
+      'idle watcher',
+      'child',
+      'sibling idle watcher'
+    ])
+  })
+
+  // #1801
+  test('watcher in a lane on a prop updated by the parent', async () => {
+    const calls: string[] = []
+    const count = ref(0)
+    const Child = {
+      props: ['count'],
+      setup(props: { count: number }) {
+        const doubled = ref(0)
+        watch(
+          () => props.count,
+          value => {
+            calls.push('watcher')
+            doubled.value = value * 2
+          },
+          { lane: 'idle' }
+        )
+        return () => {
+          calls.push('child')
+          return doubled.value
+        }
+      }
+    }
+    const Parent = {
+      render() {
+        calls.push('parent')
+        return h(Child, { count: count.value })
+      }
+    }
+    const root = nodeOps.createElement('div')
+    render(h(Parent), root)
+    calls.length = 0
+
+    count.value++
+    await nextTick()
+    expect(calls).toEqual(['parent', 'watcher', 'child'])
+    expect(serializeInner(root)).toBe('2')
+  })
 })
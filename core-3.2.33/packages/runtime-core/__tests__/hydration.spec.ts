@@ -542,6 +542,62 @@ describe('SSR hydration', () => {
     expect(container.innerHTML).toBe(`<span>1</span>`)
   })
 
+  test('Suspense (streamed out of order)', async () => {
+    const AsyncChild = {
+      async setup() {
+        const count = ref(0)
+        return () =>
+          h(
+            'span',
+            {
+              onClick: () => {
+                count.value++
+              }
+            },
+            count.value
+          )
+      }
+    }
+    const { container } = mountWithHydration(
+      '<div><!--$--><span>0</span><!--/$--><p>after</p></div>',
+      () => h('div', [h(Suspense, () => h(AsyncChild)), h('p', 'after')])
+    )
+    // wait for hydration to finish
+    await new Promise(r => setTimeout(r))
+    // boundary markers are removed
+    expect(container.innerHTML).toBe(`<div><span>0</span><p>after</p></div>`)
+    triggerEvent('click', container.querySelector('span')!)
+    await nextTick()
+    expect(container.innerHTML).toBe(`<div><span>1</span><p>after</p></div>`)
+    expect(`Hydration node mismatch`).not.toHaveBeenWarned()
+  })
+
+  test('Suspense (streamed out of order, not swapped in yet)', async () => {
+    const AsyncChild = {
+      async setup() {
+        return () => h('span', 'async')
+      }
+    }
+    const Comp = {
+      render: () =>
+        h(Suspense, null, {
+          default: h(AsyncChild),
+          fallback: h('p', 'loading')
+        })
+    }
+    const { container } = mountWithHydration(
+      '<!--[--><!--$?--><template id="vb:0"></template><p>loading</p>' +
+        '<!--/$--><div>after</div><!--]-->',
+      () => [h(Comp), h('div', 'after')]
+    )
+    await new Promise(r => setTimeout(r))
+    // the content is rendered on the client instead
+    expect(container.innerHTML).toBe(
+      `<!--[--><span>async</span><div>after</div><!--]-->`
+    )
+    expect(`Hydration node mismatch`).not.toHaveBeenWarned()
+  })
+
   test('Suspense (full integration)', async () => {
     const mountedCalls: number[] = []
     const asyncDeps: Promise<any>[] = []
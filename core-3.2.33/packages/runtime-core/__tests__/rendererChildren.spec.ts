@@ -6,7 +6,9 @@ import {
   NodeTypes,
   TestElement,
   serialize,
-  serializeInner
+  serializeInner,
+  createRenderer,
+  TestNode
 } from '@vue/runtime-test'
 function toSpan(content: any) {
   if (typeof content === 'string') {
@@ -434,6 +436,137 @@ describe('renderer: keyed children', () => {
     renderChildren([1, 6, 6, 3, 5])
     expect(`Duplicate keys`).toHaveBeenWarned()
   })
+
+  test('should reuse elements when shuffling many integer keys', () => {
+    const keys = [...Array(1000).keys()]
+    elm = renderChildren(keys)
+    const elements = elm.children.slice()
+
+    const shuffled = shuffle(keys.slice())
+    elm = renderChildren(shuffled)
+    expect((elm.children as TestElement[]).map(inner)).toEqual(
+      shuffled.map(String)
+    )
+    expect(elm.children).toEqual(shuffled.map(key => elements[key]))
+  })
+
+  test('should not match integer keys with other keys', () => {
+    const renderKeys = (keys: any[]) =>
+      render(h('div', keys.map(key => h('span', { key }, String(key)))), root)
+    renderKeys([1, 2, 3, '4'])
+    elm = root.children[0] as TestElement
+    const [one, two, three, four] = elm.children
+
+    // all integer keys, the old '4' key must not match 4
+    renderKeys([4, 3, 2, 1])
+    expect((elm.children as TestElement[]).map(inner)).toEqual([
+      '4',
+      '3',
+      '2',
+      '1'
+    ])
+    expect(elm.children[0]).not.toBe(four)
+    expect(elm.children.slice(1)).toEqual([three, two, one])
+
+    // sparse and non-integer keys
+    renderKeys([1000000, 2.5, '1', 4, 3])
+    expect((elm.children as TestElement[]).map(inner)).toEqual([
+      '1000000',
+      '2.5',
+      '1',
+      '4',
+      '3'
+    ])
+    expect(elm.children[4]).toBe(three)
+  })
+
+  test('should insert adjacent moved children in one go', () => {
+    // the nodes array is reused by the renderer
+    const batches: string[][] = []
+    const { render } = createRenderer({
+      ...nodeOps,
+      insertMany(nodes: TestNode[], parent, ref) {
+        batches.push(nodes.map(inner))
+        nodes.forEach(node => nodeOps.insert(node, parent, ref))
+      },
+      patchProp() {}
+    })
+    const renderKeys = (keys: number[]) =>
+      render(h('div', keys.map(toSpan)), root)
+
+    renderKeys([1, 2, 3, 4, 5, 6])
+    elm = root.children[0] as TestElement
+    // 1 is stable, the others are moved as one run
+    renderKeys([6, 5, 4, 3, 2, 1])
+    expect((elm.children as TestElement[]).map(inner)).toEqual([
+      '6',
+      '5',
+      '4',
+      '3',
+      '2',
+      '1'
+    ])
+    expect(batches).toEqual([['6', '5', '4', '3', '2']])
+
+    // runs are split by stable children
+    renderKeys([1, 2, 3, 4, 5, 6, 7, 8])
+    batches.length = 0
+    renderKeys([7, 8, 1, 5, 6, 2, 3, 4])
+    expect((elm.children as TestElement[]).map(inner)).toEqual([
+      '7',
+      '8',
+      '1',
+      '5',
+      '6',
+      '2',
+      '3',
+      '4'
+    ])
+    expect(batches).toEqual([
+      ['5', '6'],
+      ['7', '8']
+    ])
+  })
+
+  test('should move children one by one without insertMany', () => {
+    const { insertMany, ...ops } = nodeOps
+    const { render } = createRenderer({ ...ops, patchProp() {} })
+    const keys = [...Array(20).keys()]
+    render(h('div', keys.map(toSpan)), root)
+    const shuffled = shuffle(keys.slice())
+    render(h('div', shuffled.map(toSpan)), root)
+    elm = root.children[0] as TestElement
+    expect((elm.children as TestElement[]).map(inner)).toEqual(
+      shuffled.map(String)
+    )
+  })
+
+  test('nested keyed reorders', () => {
+    const renderTable = (rows: number[], cells: number[]) =>
+      render(
+        h(
+          'div',
+          rows.map(row =>
+            h(
+              'div',
+              { key: row },
+              cells.map(cell => h('span', { key: cell }, `${row}-${cell}`))
+            )
+          )
+        ),
+        root
+      )
+    renderTable([0, 1, 2, 3], [0, 1, 2, 3])
+    renderTable([3, 1, 0, 2], [2, 0, 3, 1])
+    elm = root.children[0] as TestElement
+    expect(
+      (elm.children as TestElement[]).map(row =>
+        (row.children as TestElement[]).map(inner)
+      )
+    ).toEqual(
+      [3, 1, 0, 2].map(row => [2, 0, 3, 1].map(cell => `${row}-${cell}`))
+    )
+  })
 })
 
 describe('renderer: unkeyed children', () => {
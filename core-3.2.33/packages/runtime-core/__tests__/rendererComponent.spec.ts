@@ -10,7 +10,9 @@ import {
   inject,
   Ref,
   watch,
-  SetupContext
+  SetupContext,
+  computed,
+  listRef
 } from '@vue/runtime-test'
 
 describe('renderer: component', () => {
@@ -354,4 +356,158 @@ describe('renderer: component', () => {
     expect(serializeInner(root)).toBe(`<h1>1</h1>`)
     expect(spy).toHaveBeenCalledTimes(2)
   })
+
+  test('should not re-render when a computed used in render is unchanged', async () => {
+    const count = ref(0)
+    const isEven = computed(() => count.value % 2 === 0)
+    const spy = jest.fn()
+
+    const Comp = {
+      render() {
+        spy()
+        return h('div', isEven.value ? 'even' : 'odd')
+      }
+    }
+
+    const root = nodeOps.createElement('div')
+    render(h(Comp), root)
+    expect(serializeInner(root)).toBe(`<div>even</div>`)
+    expect(spy).toHaveBeenCalledTimes(1)
+
+    count.value += 2
+    await nextTick()
+    expect(spy).toHaveBeenCalledTimes(1)
+
+    count.value++
+    await nextTick()
+    expect(serializeInner(root)).toBe(`<div>odd</div>`)
+    expect(spy).toHaveBeenCalledTimes(2)
+  })
+
+  test('$forceUpdate should re-render even if nothing changed', async () => {
+    const spy = jest.fn()
+    let instance: any
+    const Comp = {
+      render(this: any) {
+        instance = this
+        spy()
+        return h('div')
+      }
+    }
+
+    const root = nodeOps.createElement('div')
+    render(h(Comp), root)
+    expect(spy).toHaveBeenCalledTimes(1)
+    instance.$forceUpdate()
+    await nextTick()
+    expect(spy).toHaveBeenCalledTimes(2)
+  })
+
+  test('should only re-render rows whose item changed in a listRef', async () => {
+    const renderedIds: number[] = []
+    const Row = {
+      props: ['item'],
+      render(this: any) {
+        renderedIds.push(this.item.id)
+        return h('li', this.item.label)
+      }
+    }
+    const rows = listRef(
+      [
+        { id: 1, label: 'a' },
+        { id: 2, label: 'b' },
+        { id: 3, label: 'c' }
+      ],
+      { key: 'id' }
+    )
+    const List = {
+      render: () =>
+        h('ul', rows.value.map(item => h(Row, { key: item.id, item })))
+    }
+
+    const root = nodeOps.createElement('div')
+    render(h(List), root)
+    expect(renderedIds).toEqual([1, 2, 3])
+
+    // e.g. fresh objects from polling, with a single changed row
+    renderedIds.length = 0
+    rows.value = [
+      { id: 1, label: 'a' },
+      { id: 2, label: 'B' },
+      { id: 3, label: 'c' }
+    ]
+    await nextTick()
+    expect(serializeInner(root)).toBe(
+      `<ul><li>a</li><li>B</li><li>c</li></ul>`
+    )
+    expect(renderedIds).toEqual([2])
+  })
+
+  test('should update components by lane', async () => {
+    const calls: string[] = []
+    const query = ref('')
+    const Analytics = {
+      lane: 'idle' as const,
+      render() {
+        calls.push('analytics')
+        return h('div', query.value.length)
+      }
+    }
+    const SearchBox = {
+      lane: 'user-blocking' as const,
+      render() {
+        calls.push('search box')
+        return h('input', { value: query.value })
+      }
+    }
+    const root = nodeOps.createElement('div')
+    render(h('div', [h(Analytics), h(SearchBox)]), root)
+    calls.length = 0
+
+    query.value = 'vue'
+    let painted: string[] | undefined
+    // the flush yields before the idle lane
+    setImmediate(() => (painted = calls.slice()))
+    await nextTick()
+    expect(painted).toEqual(['search box'])
+    expect(calls).toEqual(['search box', 'analytics'])
+    expect(serializeInner(root)).toBe(
+      `<div><div>3</div><input value="vue"></input></div>`
+    )
+  })
+
+  test('should take the lane from mixins and extends', async () => {
+    const calls: string[] = []
+    const count = ref(0)
+    const Idle = { lane: 'idle' as const }
+    const Chart = {
+      mixins: [Idle],
+      render() {
+        calls.push('chart')
+        return count.value
+      }
+    }
+    const Table = {
+      extends: Idle,
+      render() {
+        calls.push('table')
+        return count.value
+      }
+    }
+    const Input = {
+      render() {
+        calls.push('input')
+        return count.value
+      }
+    }
+    render(
+      h('div', [h(Chart), h(Table), h(Input)]),
+      nodeOps.createElement('div')
+    )
+    calls.length = 0
+
+    count.value++
+    await nextTick()
+    expect(calls).toEqual(['input', 'chart', 'table'])
+  })
 })
@@ -5,7 +5,8 @@ import {
   invalidateJob,
   queuePreFlushCb,
   flushPreFlushCbs,
-  flushPostFlushCbs
+  flushPostFlushCbs,
+  flushPreJobs
 } from '../src/scheduler'
 
 describe('scheduler', () => {
@@ -450,6 +451,48 @@ describe('scheduler', () => {
     expect(calls).toEqual(['job3', 'job2', 'job1'])
   })
 
+  test('sort jobs queued during flush based on id', async () => {
+    const calls: number[] = []
+    const jobs = Array.from({ length: 100 }, (_, id) => {
+      const job = () => calls.push(id)
+      job.id = id
+      return job
+    })
+    // queue in reverse order, with duplicates, partly while flushing
+    const first = () => {
+      for (let i = 99; i >= 0; i--) {
+        queueJob(jobs[i])
+        queueJob(jobs[i])
+      }
+    }
+    first.id = -1
+    for (let i = 99; i >= 50; i--) {
+      queueJob(jobs[i])
+    }
+    queueJob(first)
+    await nextTick()
+    expect(calls).toEqual(jobs.map((_, id) => id))
+  })
+
+  test('invalidated job queued again runs once', async () => {
+    const calls: string[] = []
+    const job1 = () => {
+      calls.push('job1')
+      invalidateJob(job2)
+      queueJob(job2)
+      invalidateJob(job2)
+      queueJob(job2)
+    }
+    job1.id = 1
+    const job2 = () => calls.push('job2')
+    job2.id = 2
+
+    queueJob(job2)
+    queueJob(job1)
+    await nextTick()
+    expect(calls).toEqual(['job1', 'job2'])
+  })
+
   test('sort SchedulerCbs based on id', async () => {
     const calls: string[] = []
     const cb1 = () => calls.push('cb1')
@@ -573,6 +616,217 @@ describe('scheduler', () => {
     expect(count).toBe(1)
   })
 
+  describe('time slicing', () => {
+    const busyWait = (ms: number) => {
+      const start = Date.now()
+      while (Date.now() - start < ms) {}
+    }
+
+    test('should yield once the budget is spent', async () => {
+      const calls: string[] = []
+      const job1 = () => {
+        calls.push('job1')
+        // runs in the task before the flush resumes
+        setImmediate(() => calls.push('task'))
+        busyWait(2)
+      }
+      job1.id = 1
+      job1.budget = 1
+      const job2 = () => calls.push('job2')
+      job2.id = 2
+
+      queueJob(job2)
+      queueJob(job1)
+      // resolves after the whole flush
+      await nextTick()
+      expect(calls).toEqual(['job1', 'task', 'job2'])
+    })
+
+    test('should keep id order across slices', async () => {
+      const calls: number[] = []
+      const jobs = Array.from({ length: 5 }, (_, id) => {
+        const job = () => {
+          calls.push(id)
+          busyWait(2)
+        }
+        job.id = id
+        job.budget = 1
+        return job
+      })
+      for (let i = 4; i >= 0; i--) {
+        queueJob(jobs[i])
+      }
+      await nextTick()
+      expect(calls).toEqual([0, 1, 2, 3, 4])
+    })
+
+    test('jobs queued while yielded should keep id order', async () => {
+      const calls: string[] = []
+      const job0 = () => calls.push('job0')
+      job0.id = 0
+      const job1 = () => {
+        calls.push('job1')
+        // e.g. an event handler
+        setImmediate(() => {
+          queueJob(job4)
+          queueJob(job0)
+        })
+        busyWait(2)
+      }
+      job1.id = 1
+      job1.budget = 1
+      const job2 = () => calls.push('job2')
+      job2.id = 2
+      const job3 = () => calls.push('job3')
+      job3.id = 3
+      const job4 = () => {
+        calls.push('job4')
+        queueJob(job5)
+      }
+      job4.id = 4
+      const job5 = () => calls.push('job5')
+      job5.id = 5
+      const cb = () => calls.push('cb')
+
+      queueJob(job1)
+      queueJob(job2)
+      queueJob(job3)
+      queuePostFlushCb(cb)
+      await nextTick()
+      // post-flush callbacks only wait for the jobs queued before the flush
+      // yielded
+      expect(calls).toEqual([
+        'job1',
+        'job0',
+        'job2',
+        'job3',
+        'cb',
+        'job4',
+        'job5'
+      ])
+    })
+
+    test('should count recursive updates per slice', async () => {
+      let count = 0
+      let done!: () => void
+      const finished = new Promise<void>(r => (done = r))
+      const job = () => {
+        // e.g. an animation updating a component in every slice
+        if (++count < 150) {
+          queueJob(job)
+        } else {
+          done()
+        }
+        busyWait(2)
+      }
+      job.id = 1
+      job.budget = 1
+      job.allowRecurse = true
+
+      queueJob(job)
+      await finished
+      expect(count).toBe(150)
+    })
+  })
+
+  describe('lanes', () => {
+    test('should flush jobs by lane, then by id', async () => {
+      const calls: string[] = []
+      const job1 = () => calls.push('job1')
+      job1.id = 1
+      job1.lane = 'idle' as const
+      const job2 = () => calls.push('job2')
+      job2.id = 2
+      const job3 = () => calls.push('job3')
+      job3.id = 3
+      job3.lane = 'user-blocking' as const
+      const job4 = () => calls.push('job4')
+      job4.id = 4
+      job4.lane = 'immediate' as const
+      const job5 = () => calls.push('job5')
+      job5.id = 5
+      job5.lane = 'user-blocking' as const
+
+      queueJob(job5)
+      queueJob(job1)
+      queueJob(job2)
+      queueJob(job3)
+      queueJob(job4)
+      await nextTick()
+      expect(calls).toEqual(['job4', 'job3', 'job5', 'job2', 'job1'])
+    })
+
+    test('should yield before the idle lane', async () => {
+      const calls: string[] = []
+      const job1 = () => calls.push('job1')
+      job1.id = 1
+      job1.lane = 'idle' as const
+      const job2 = () => {
+        calls.push('job2')
+        setImmediate(() => calls.push('task'))
+      }
+      job2.id = 2
+
+      queueJob(job1)
+      queueJob(job2)
+      await nextTick()
+      expect(calls).toEqual(['job2', 'task', 'job1'])
+    })
+
+    test('normal jobs queued by higher lane jobs should be promoted', async () => {
+      const calls: string[] = []
+      const job1 = () => {
+        calls.push('job1')
+        queueJob(job3)
+        queueJob(job4)
+      }
+      job1.id = 1
+      job1.lane = 'user-blocking' as const
+      const job2 = () => calls.push('job2')
+      job2.id = 2
+      const job3 = () => calls.push('job3')
+      job3.id = 3
+      const job4 = () => calls.push('job4')
+      job4.id = 4
+      job4.lane = 'idle' as const
+
+      queueJob(job2)
+      queueJob(job1)
+      await nextTick()
+      expect(calls).toEqual(['job1', 'job3', 'job2', 'job4'])
+    })
+
+    test('flushPreJobs should only run the pre jobs of the given id', async () => {
+      const calls: string[] = []
+      const pre1 = () => {
+        calls.push('pre1')
+        // queued again while flushing: run in the same call
+        if (calls.length === 1) queueJob(pre1)
+      }
+      pre1.id = 1
+      pre1.pre = true
+      pre1.lane = 'idle' as const
+      const pre2 = () => calls.push('pre2')
+      pre2.id = 2
+      pre2.pre = true
+      pre2.lane = 'idle' as const
+      const invalidated = () => calls.push('invalidated')
+      invalidated.id = 1
+      invalidated.pre = true
+
+      queueJob(pre2)
+      queueJob(pre1)
+      queueJob(invalidated)
+      invalidateJob(invalidated)
+      flushPreJobs(1)
+      expect(calls).toEqual(['pre1', 'pre1'])
+
+      // the heap entries of jobs run by flushPreJobs are skipped
+      await nextTick()
+      expect(calls).toEqual(['pre1', 'pre1', 'pre2'])
+    })
+  })
+
   // #910
   test('should not run stopped reactive effects', async () => {
     const spy = jest.fn()
@@ -98,6 +98,18 @@ export interface AppConfig {
    * TODO deprecate in 3.3
    */
   unwrapInjectedRef?: boolean
+
+  /**
+   * Flush the component updates of this app in time slices: once a flush has
+   * run for the budget (in ms, 5 when `true`), it yields to the event loop
+   * so that input can be handled and the browser can paint. Updates still
+   * run in parent-to-child order, including the ones queued meanwhile (e.g.
+   * by event handlers) - use the `lane` option of components to let urgent
+   * updates go first. Post-flush callbacks and `nextTick()` wait for the
+   * updates queued before the flush yielded, the others are flushed right
+   * after.
+   */
+  timeSlicing?: boolean | number
 }
 
 export interface AppContext {
@@ -9,7 +9,12 @@ import {
   EffectScheduler,
   DebuggerOptions
 } from '@vue/reactivity'
-import { SchedulerJob, queuePreFlushCb } from './scheduler'
+import {
+  SchedulerJob,
+  SchedulerLane,
+  queueJob,
+  queuePreFlushCb
+} from './scheduler'
 import {
   EMPTY_OBJ,
   isObject,
@@ -67,6 +72,13 @@ type OnCleanup = (cleanupFn: () => void) => void
 
 export interface WatchOptionsBase extends DebuggerOptions {
   flush?: 'pre' | 'post' | 'sync'
+  /**
+   * Queue the callback in a scheduler lane instead of before all component
+   * updates. It still runs before the update of its own component, even when
+   * the component is in a higher lane or is updated by its parent.
+   * Only applies to `flush: 'pre'`.
+   */
+  lane?: SchedulerLane
 }
 
 export interface WatchOptions<Immediate = boolean> extends WatchOptionsBase {
@@ -217,7 +229,14 @@ export function watch<T = any, Immediate extends Readonly<boolean> = false>(
 function doWatch(
   source: WatchSource | WatchSource[] | WatchEffect | object,
   cb: WatchCallback | null,
-  { immediate, deep, flush, onTrack, onTrigger }: WatchOptions = EMPTY_OBJ
+  {
+    immediate,
+    deep,
+    flush,
+    lane,
+    onTrack,
+    onTrigger
+  }: WatchOptions = EMPTY_OBJ
 ): WatchStopHandle {
   //对immediate、deep做校验，如果cb为null，immediate、deep不为undefined进行提示
   if (__DEV__ && !cb) {
@@ -385,7 +404,8 @@ function doWatch(
 
   let oldValue = isMultiSource ? [] : INITIAL_WATCHER_VALUE
   const job: SchedulerJob = () => {
-    if (!effect.active) {
+    // not dirty: only notified by computeds whose values did not change
+    if (!effect.active || !effect.dirty) {
       return
     }
     if (cb) {
@@ -435,9 +455,16 @@ function doWatch(
   } else {
     // default: 'pre'
     // 默认 pre，将job添加到一个优先执行队列，该队列在挂载前执行
+    if (lane) {
+      // queued in the main queue instead, right before the update of its
+      // component, or before all component updates of the lane
+      job.lane = lane
+      job.pre = true
+      job.id = instance ? instance.uid : -1
+    }
     scheduler = () => {
       if (!instance || instance.isMounted) {
-        queuePreFlushCb(job)
+        lane ? queueJob(job) : queuePreFlushCb(job)
       } else {
         // with 'pre' option, the first call must happen before
         // the component is mounted so it is called synchronously.
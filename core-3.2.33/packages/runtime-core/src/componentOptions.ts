@@ -71,6 +71,7 @@ import {
   softAssertCompatEnabled
 } from './compat/compatConfig'
 import { OptionMergeFunction } from './apiCreateApp'
+import { SchedulerLane } from './scheduler'
 
 /**
  * Interface for declaring custom options.
@@ -146,7 +147,25 @@ export interface ComponentOptionsBase<
   emits?: (E | EE[]) & ThisType<void>
   // TODO infer public instance type based on exposed keys
   expose?: string[]
+  /**
+   * The scheduler lane of the component's updates, e.g. `'user-blocking'`
+   * for an input that must stay responsive or `'idle'` for an expensive
+   * panel that can wait for the next task. Merged from mixins and `extends`
+   * like the other options.
+   */
+  lane?: SchedulerLane
   serverPrefetch?(): Promise<any>
+  /**
+   * SSR only. Opt-in render cache: when the server render context has a
+   * `componentCache`, the rendered HTML is cached under the component's name
+   * and the returned key, and later renders with the same key skip setup and
+   * render entirely. The key must account for everything the output depends
+   * on. Return a falsy value to skip the cache for a given render.
+   * Components that render teleports or Suspense boundaries streamed out of
+   * order are not cached, and the `modules` a cached component registers in
+   * the SSR context are not collected on hits.
+   */
+  serverCacheKey?: (props: Data) => string | number | false | null | undefined
 
   // Runtime compiler only -----------------------------------------------------
   compilerOptions?: RuntimeCompilerOptions
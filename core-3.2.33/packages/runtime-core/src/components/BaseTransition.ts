@@ -238,6 +238,7 @@ const BaseTransitionImpl: ComponentOptions = {
           // return placeholder node and queue update when leave finishes
           leavingHooks.afterLeave = () => {
             state.isLeaving = false
+            instance.effect.dirty = true
             instance.update()
           }
           return emptyPlaceholder(child)
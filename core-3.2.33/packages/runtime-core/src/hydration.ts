@@ -44,6 +44,11 @@ const isSVGContainer = (container: Element) =>
 const isComment = (node: Node): node is Comment =>
   node.nodeType === DOMNodeTypes.COMMENT
 
+// start of a Suspense boundary streamed out of order, either already swapped
+// in (<!--$-->) or still pending (<!--$?-->)
+const isSuspenseStart = (node: Node): node is Comment =>
+  isComment(node) && (node.data === '$' || node.data === '$?')
+
 // Note: hydration is DOM-specific
 // But we have to place it in core due to tight coupling with core - splitting
 // it out creates a ton of unnecessary complexity.
@@ -185,6 +190,12 @@ export function createHydrationFunctions(
           // on its sub-tree.
           vnode.slotScopeIds = slotScopeIds
           const container = parentNode(node)!
+          // a component rendering an out-of-order Suspense boundary as root
+          // removes the boundary markers while hydrating, so locate the end
+          // beforehand
+          const suspenseEnd = isSuspenseStart(node)
+            ? locateClosingSuspenseAnchor(node)
+            : undefined
           mountComponent(
             vnode,
             container,
@@ -200,6 +211,8 @@ export function createHydrationFunctions(
           // instead, we do a lookahead to find the end anchor node.
           nextNode = isFragmentStart
             ? locateClosingAsyncAnchor(node)
+            : suspenseEnd !== undefined
+            ? suspenseEnd
             : nextSibling(node)
 
           // #3787
@@ -236,17 +249,52 @@ export function createHydrationFunctions(
             )
           }
         } else if (__FEATURE_SUSPENSE__ && shapeFlag & ShapeFlags.SUSPENSE) {
-          nextNode = (vnode.type as typeof SuspenseImpl).hydrate(
-            node,
-            vnode,
-            parentComponent,
-            parentSuspense,
-            isSVGContainer(parentNode(node)!),
-            slotScopeIds,
-            optimized,
-            rendererInternals,
-            hydrateNode
-          )
+          if (isComment(node) && node.data === '$?') {
+            // boundary streamed out of order whose content has not been
+            // swapped in yet - drop the fallback and render on the client
+            const container = parentNode(node)!
+            nextNode = removeSuspenseBoundary(node)
+            patch(
+              null,
+              vnode,
+              container,
+              nextNode,
+              parentComponent,
+              parentSuspense,
+              isSVGContainer(container),
+              slotScopeIds
+            )
+          } else {
+            // boundary streamed out of order and already swapped in: the
+            // content is wrapped in <!--$--> and <!--/$--> markers
+            const isSwapped = isSuspenseStart(node)
+            if (isSwapped) {
+              const start = node
+              vnode.el = node = nextSibling(node)!
+              remove(start)
+            }
+            nextNode = (vnode.type as typeof SuspenseImpl).hydrate(
+              node,
+              vnode,
+              parentComponent,
+              parentSuspense,
+              isSVGContainer(parentNode(node)!),
+              slotScopeIds,
+              optimized,
+              rendererInternals,
+              hydrateNode
+            )
+            if (
+              isSwapped &&
+              nextNode &&
+              isComment(nextNode) &&
+              nextNode.data === '/$'
+            ) {
+              const end = nextNode
+              nextNode = nextSibling(nextNode)
+              remove(end)
+            }
+          }
         } else if (__DEV__) {
           warn('Invalid HostVNode type:', type, `(${typeof type})`)
         }
@@ -520,6 +568,36 @@ export function createHydrationFunctions(
     return next
   }
 
+  // removes a pending out-of-order Suspense boundary, from its <!--$?-->
+  // start marker up to and including the matching <!--/$-->
+  const removeSuspenseBoundary = (node: Node): Node | null => {
+    const end = locateClosingSuspenseAnchor(node)
+    while (node !== end) {
+      const next = nextSibling(node)!
+      remove(node)
+      node = next
+    }
+    return end
+  }
+
+  const locateClosingSuspenseAnchor = (node: Node | null): Node | null => {
+    let match = 0
+    while (node) {
+      node = nextSibling(node)
+      if (node && isComment(node)) {
+        if (node.data === '$' || node.data === '$?') match++
+        if (node.data === '/$') {
+          if (match === 0) {
+            return nextSibling(node)
+          } else {
+            match--
+          }
+        }
+      }
+    }
+    return node
+  }
+
   const locateClosingAsyncAnchor = (node: Node | null): Node | null => {
     let match = 0
     while (node) {
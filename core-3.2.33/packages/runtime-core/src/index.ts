@@ -20,13 +20,16 @@ export {
   customRef,
   triggerRef,
   shallowRef,
+  listRef,
   shallowReactive,
   shallowReadonly,
   markRaw,
   toRaw,
+  iterateRaw,
   // effect
   effect,
   stop,
+  batch,
   ReactiveEffect,
   // effect scope
   effectScope,
@@ -156,6 +159,7 @@ export {
   ShallowRef,
   ShallowUnwrapRef,
   CustomRefFactory,
+  ListRefOptions,
   ReactiveFlags,
   DeepReadonly,
   ShallowReactive,
@@ -182,6 +186,7 @@ export {
   WatchSource,
   WatchStopHandle
 } from './apiWatch'
+export { SchedulerLane } from './scheduler'
 export { InjectionKey } from './apiInject'
 export {
   App,
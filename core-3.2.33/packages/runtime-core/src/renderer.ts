@@ -26,6 +26,7 @@ import {
   shouldUpdateComponent,
   updateHOCHostEl
 } from './componentRenderUtils'
+import { resolveMergedOptions } from './componentOptions'
 import {
   EMPTY_OBJ,
   EMPTY_ARR,
@@ -43,7 +44,9 @@ import {
   flushPostFlushCbs,
   invalidateJob,
   flushPreFlushCbs,
-  SchedulerJob
+  flushPreJobs,
+  SchedulerJob,
+  DEFAULT_FLUSH_BUDGET
 } from './scheduler'
 import { pauseTracking, resetTracking, ReactiveEffect } from '@vue/reactivity'
 import { updateProps } from './componentProps'
@@ -104,6 +107,17 @@ export interface RendererOptions<
     unmountChildren?: UnmountChildrenFn
   ): void
   insert(el: HostNode, parent: HostElement, anchor?: HostNode | null): void
+  /**
+   * Inserts a run of sibling nodes, in order, before the anchor, e.g. through
+   * a DocumentFragment. Used when a keyed diff moves several adjacent
+   * children. Renderers without it get one `insert()` call per node. The
+   * nodes array is reused by the renderer and must not be retained.
+   */
+  insertMany?(
+    nodes: HostNode[],
+    parent: HostElement,
+    anchor?: HostNode | null
+  ): void
   remove(el: HostNode): void
   createElement(
     type: string,
@@ -340,6 +354,7 @@ function baseCreateRenderer(
 
   const {
     insert: hostInsert,
+    insertMany: hostInsertMany,
     remove: hostRemove,
     patchProp: hostPatchProp,
     createElement: hostCreateElement,
@@ -1306,6 +1321,7 @@ function baseCreateRenderer(
         // double updating the same child component in the same flush.
         invalidateJob(instance.update)
         // instance.update is the reactive effect.
+        instance.effect.dirty = true
         instance.update()
       }
     } else {
@@ -1491,6 +1507,11 @@ function baseCreateRenderer(
         } else {
           next = vnode
         }
+        // watchers queued in a lane run before the update of their component,
+        // even when the component is in a higher lane
+        pauseTracking()
+        flushPreJobs(instance.uid)
+        resetTracking()
 
         // beforeUpdate hook
         if (bu) {
@@ -1583,8 +1604,25 @@ function baseCreateRenderer(
       instance.scope // track it in component's effect scope
     ))
 
-    const update = (instance.update = effect.run.bind(effect) as SchedulerJob)
+    // skip the render when the effect was only notified by computeds whose
+    // values turned out to be unchanged
+    const update: SchedulerJob = (instance.update = () => {
+      if (effect.dirty) {
+        effect.run()
+      }
+    })
     update.id = instance.uid
+    // the option may come from mixins or `extends`
+    const { lane } = (
+      __FEATURE_OPTIONS_API__ ? resolveMergedOptions(instance) : instance.type
+    ) as ComponentOptions
+    if (lane) {
+      update.lane = lane
+    }
+    const { timeSlicing } = instance.appContext.config
+    if (timeSlicing) {
+      update.budget = timeSlicing === true ? DEFAULT_FLUSH_BUDGET : timeSlicing
+    }
     // allowRecurse
     // #1801, #2043 component render effects should allow recursive updates
     toggleRecurse(instance, true)
@@ -1906,125 +1944,222 @@ function baseCreateRenderer(
       const s1 = i // prev starting index
       const s2 = i // next starting index
 
-      // 5.1 build key:index map for newChildren
-      const keyToNewIndexMap: Map<string | number | symbol, number> = new Map()
-      for (i = s2; i <= e2; i++) {
-        const nextChild = (c2[i] = optimized
-          ? cloneIfMounted(c2[i] as VNode)
-          : normalizeVNode(c2[i]))
-        if (nextChild.key != null) {
-          if (__DEV__ && keyToNewIndexMap.has(nextChild.key)) {
-            warn(
-              `Duplicate keys found during update:`,
-              JSON.stringify(nextChild.key),
-              `Make sure keys are unique.`
-            )
-          }
-          keyToNewIndexMap.set(nextChild.key, i)
-        }
-      }
-
-      // 5.2 loop through old children left to be patched and try to patch
-      // matching nodes & remove nodes that are no longer present
-      let j
-      let patched = 0
       const toBePatched = e2 - s2 + 1
-      let moved = false
-      // used to track whether any node has moved
-      let maxNewIndexSoFar = 0
-      // works as Map<newIndex, oldIndex>
-      // Note that oldIndex is offset by +1
-      // and oldIndex = 0 is a special value indicating the new node has
-      // no corresponding old node.
-      // used for determining longest stable subsequence
-      const newIndexToOldIndexMap = new Array(toBePatched)
-      for (i = 0; i < toBePatched; i++) newIndexToOldIndexMap[i] = 0
-
-      for (i = s1; i <= e1; i++) {
-        const prevChild = c1[i]
-        if (patched >= toBePatched) {
-          // all new children have been patched so this can only be a removal
-          unmount(prevChild, parentComponent, parentSuspense, true)
-          continue
+      // children are patched recursively while this diff is in progress, so
+      // each nesting level has its own scratch buffers
+      const buffers = getKeyedDiffBuffers(keyedDiffDepth++, toBePatched)
+      try {
+        // 5.1 build key:index map for newChildren
+        // when all keys are integers in a range not much larger than the
+        // number of children, e.g. row ids, they are looked up in an array
+        // indexed by key instead of a Map
+        let minKey = Infinity
+        let maxKey = -Infinity
+        for (i = s2; i <= e2; i++) {
+          const nextChild = (c2[i] = optimized
+            ? cloneIfMounted(c2[i] as VNode)
+            : normalizeVNode(c2[i]))
+          const key = nextChild.key
+          if (typeof key === 'number' && (key | 0) === key) {
+            if (key < minKey) minKey = key
+            if (key > maxKey) maxKey = key
+          } else {
+            minKey = NaN
+          }
         }
-        let newIndex
-        if (prevChild.key != null) {
-          newIndex = keyToNewIndexMap.get(prevChild.key)
+        const keyRange = maxKey - minKey + 1
+        // NaN when a key is missing or not an integer
+        const useKeyIndex = keyRange <= toBePatched * 4
+        let keyToNewIndexMap: Map<string | number | symbol, number> | undefined
+        let keyIndex: Int32Array | undefined
+        if (useKeyIndex) {
+          // index + 1 of the new child with each key, 0 when none has it
+          keyIndex = buffers.keyIndex =
+            buffers.keyIndex.length < keyRange
+              ? new Int32Array(keyRange * 2)
+              : buffers.keyIndex.fill(0, 0, keyRange)
         } else {
-          // key-less node, try to locate a key-less node of the same type
-          for (j = s2; j <= e2; j++) {
-            if (
-              newIndexToOldIndexMap[j - s2] === 0 &&
-              isSameVNodeType(prevChild, c2[j] as VNode)
-            ) {
-              newIndex = j
-              break
+          keyToNewIndexMap = new Map()
+        }
+        for (i = s2; i <= e2; i++) {
+          const key = (c2[i] as VNode).key
+          if (key != null) {
+            if (keyIndex) {
+              if (__DEV__ && keyIndex[(key as number) - minKey] !== 0) {
+                warn(
+                  `Duplicate keys found during update:`,
+                  JSON.stringify(key),
+                  `Make sure keys are unique.`
+                )
+              }
+              keyIndex[(key as number) - minKey] = i + 1
+            } else {
+              if (__DEV__ && keyToNewIndexMap!.has(key)) {
+                warn(
+                  `Duplicate keys found during update:`,
+                  JSON.stringify(key),
+                  `Make sure keys are unique.`
+                )
+              }
+              keyToNewIndexMap!.set(key, i)
             }
           }
         }
-        if (newIndex === undefined) {
-          unmount(prevChild, parentComponent, parentSuspense, true)
-        } else {
-          newIndexToOldIndexMap[newIndex - s2] = i + 1
-          if (newIndex >= maxNewIndexSoFar) {
-            maxNewIndexSoFar = newIndex
+
+        // 5.2 loop through old children left to be patched and try to patch
+        // matching nodes & remove nodes that are no longer present
+        let j
+        let patched = 0
+        let moved = false
+        // used to track whether any node has moved
+        let maxNewIndexSoFar = 0
+        // works as Map<newIndex, oldIndex>
+        // Note that oldIndex is offset by +1
+        // and oldIndex = 0 is a special value indicating the new node has
+        // no corresponding old node.
+        // used for determining longest stable subsequence
+        const newIndexToOldIndexMap = buffers.newIndexToOldIndexMap
+        newIndexToOldIndexMap.fill(0, 0, toBePatched)
+
+        for (i = s1; i <= e1; i++) {
+          const prevChild = c1[i]
+          if (patched >= toBePatched) {
+            // all new children have been patched so this can only be a removal
+            unmount(prevChild, parentComponent, parentSuspense, true)
+            continue
+          }
+          let newIndex
+          if (prevChild.key != null) {
+            if (keyIndex) {
+              const key = prevChild.key as number
+              // 0 for keys out of range or of another type
+              const index =
+                typeof key === 'number' && key >= minKey && key <= maxKey
+                  ? keyIndex[key - minKey]
+                  : 0
+              newIndex = index ? index - 1 : undefined
+            } else {
+              newIndex = keyToNewIndexMap!.get(prevChild.key)
+            }
           } else {
-            moved = true
+            // key-less node, try to locate a key-less node of the same type
+            for (j = s2; j <= e2; j++) {
+              if (
+                newIndexToOldIndexMap[j - s2] === 0 &&
+                isSameVNodeType(prevChild, c2[j] as VNode)
+              ) {
+                newIndex = j
+                break
+              }
+            }
+          }
+          if (newIndex === undefined) {
+            unmount(prevChild, parentComponent, parentSuspense, true)
+          } else {
+            newIndexToOldIndexMap[newIndex - s2] = i + 1
+            if (newIndex >= maxNewIndexSoFar) {
+              maxNewIndexSoFar = newIndex
+            } else {
+              moved = true
+            }
+            patch(
+              prevChild,
+              c2[newIndex] as VNode,
+              container,
+              null,
+              parentComponent,
+              parentSuspense,
+              isSVG,
+              slotScopeIds,
+              optimized
+            )
+            patched++
           }
-          patch(
-            prevChild,
-            c2[newIndex] as VNode,
-            container,
-            null,
-            parentComponent,
-            parentSuspense,
-            isSVG,
-            slotScopeIds,
-            optimized
-          )
-          patched++
         }
-      }
 
-      // 5.3 move and mount
-      // generate longest stable subsequence only when nodes have moved
-      const increasingNewIndexSequence = moved
-        ? getSequence(newIndexToOldIndexMap)
-        : EMPTY_ARR
-      j = increasingNewIndexSequence.length - 1
-      // looping backwards so that we can use last patched node as anchor
-      for (i = toBePatched - 1; i >= 0; i--) {
-        const nextIndex = s2 + i
-        const nextChild = c2[nextIndex] as VNode
-        const anchor =
-          nextIndex + 1 < l2 ? (c2[nextIndex + 1] as VNode).el : parentAnchor
-        if (newIndexToOldIndexMap[i] === 0) {
-          // mount new
-          patch(
-            null,
-            nextChild,
-            container,
-            anchor,
-            parentComponent,
-            parentSuspense,
-            isSVG,
-            slotScopeIds,
-            optimized
-          )
-        } else if (moved) {
-          // move if:
-          // There is no stable subsequence (e.g. a reverse)
-          // OR current node is not among the stable sequence
-          if (j < 0 || i !== increasingNewIndexSequence[j]) {
-            move(nextChild, container, anchor, MoveType.REORDER)
-          } else {
-            j--
+        // 5.3 move and mount
+        // generate longest stable subsequence only when nodes have moved
+        const increasingNewIndexSequence = buffers.sequence
+        j = moved
+          ? getSequence(
+              newIndexToOldIndexMap,
+              toBePatched,
+              increasingNewIndexSequence
+            ) - 1
+          : -1
+        // adjacent moved children that are single host nodes are collected and
+        // inserted in one go, when the renderer supports it
+        const batchMoves = moved && hostInsertMany !== undefined
+        // looping backwards so that we can use last patched node as anchor
+        for (i = toBePatched - 1; i >= 0; i--) {
+          const nextIndex = s2 + i
+          const nextChild = c2[nextIndex] as VNode
+          const anchor =
+            nextIndex + 1 < l2 ? (c2[nextIndex + 1] as VNode).el : parentAnchor
+          if (newIndexToOldIndexMap[i] === 0) {
+            // the anchor may be a collected node that has not been moved yet
+            if (movedNodes.length) {
+              insertMovedNodes(container)
+            }
+            // mount new
+            patch(
+              null,
+              nextChild,
+              container,
+              anchor,
+              parentComponent,
+              parentSuspense,
+              isSVG,
+              slotScopeIds,
+              optimized
+            )
+          } else if (moved) {
+            // move if:
+            // There is no stable subsequence (e.g. a reverse)
+            // OR current node is not among the stable sequence
+            if (j < 0 || i !== increasingNewIndexSequence[j]) {
+              const node = batchMoves && getMovedHostNode(nextChild)
+              if (node) {
+                if (!movedNodes.length) {
+                  movedNodesAnchor = anchor
+                }
+                movedNodes.push(node)
+              } else {
+                if (movedNodes.length) {
+                  insertMovedNodes(container)
+                }
+                move(nextChild, container, anchor, MoveType.REORDER)
+              }
+            } else {
+              // a stable node ends the run of adjacent moved nodes
+              if (movedNodes.length) {
+                insertMovedNodes(container)
+              }
+              j--
+            }
           }
         }
+        if (movedNodes.length) {
+          insertMovedNodes(container)
+        }
+      } finally {
+        keyedDiffDepth--
       }
     }
   }
 
+  // inserts the nodes collected by patchKeyedChildren, which were collected
+  // in reverse order
+  const insertMovedNodes = (container: RendererElement) => {
+    if (movedNodes.length === 1) {
+      hostInsert(movedNodes[0], container, movedNodesAnchor)
+    } else {
+      hostInsertMany!(movedNodes.reverse(), container, movedNodesAnchor)
+    }
+    movedNodes.length = 0
+    movedNodesAnchor = null
+  }
+
   const move: MoveFn = (
     vnode,
     container,
@@ -2438,23 +2573,82 @@ export function traverseStaticChildren(n1: VNode, n2: VNode, shallow = false) {
   }
 }
 
+interface KeyedDiffBuffers {
+  newIndexToOldIndexMap: Int32Array
+  sequence: Int32Array
+  keyIndex: Int32Array
+}
+
+// Scratch buffers of the unknown sequence pass of patchKeyedChildren, one
+// set per nesting level. They grow on demand and are reused across renders.
+const keyedDiffBuffers: KeyedDiffBuffers[] = []
+let keyedDiffDepth = 0
+
+function getKeyedDiffBuffers(depth: number, size: number): KeyedDiffBuffers {
+  let buffers = keyedDiffBuffers[depth]
+  if (!buffers) {
+    buffers = keyedDiffBuffers[depth] = {
+      newIndexToOldIndexMap: new Int32Array(size),
+      sequence: new Int32Array(size),
+      keyIndex: new Int32Array(0)
+    }
+  } else if (buffers.sequence.length < size) {
+    buffers.newIndexToOldIndexMap = new Int32Array(size * 2)
+    buffers.sequence = new Int32Array(size * 2)
+  }
+  return buffers
+}
+
+// adjacent children moved by patchKeyedChildren, inserted together with
+// `insertMany()`. Children are not patched while nodes are collected, so a
+// single array is enough.
+const movedNodes: RendererNode[] = []
+let movedNodesAnchor: RendererNode | null = null
+
+// the node of a vnode that is moved by a single host insert, or null for
+// fragments, static content, teleports and suspense boundaries, which move()
+// handles
+function getMovedHostNode(vnode: VNode): RendererNode | null {
+  while (vnode.shapeFlag & ShapeFlags.COMPONENT) {
+    vnode = vnode.component!.subTree
+  }
+  const { type, shapeFlag } = vnode
+  return type === Fragment ||
+    type === Static ||
+    shapeFlag & (ShapeFlags.TELEPORT | ShapeFlags.SUSPENSE)
+    ? null
+    : vnode.el
+}
+
+// predecessors of getSequence(), only used while it runs
+let sequencePredecessors = new Int32Array(0)
+
 // https://en.wikipedia.org/wiki/Longest_increasing_subsequence
-function getSequence(arr: number[]): number[] {
-  const p = arr.slice()
-  const result = [0]
+// Writes the indices of the sequence in `arr[0, len)` to `result` and returns
+// its length.
+function getSequence(
+  arr: Int32Array,
+  len: number,
+  result: Int32Array
+): number {
+  if (sequencePredecessors.length < len) {
+    sequencePredecessors = new Int32Array(len * 2)
+  }
+  const p = sequencePredecessors
+  let length = 1
+  result[0] = 0
   let i, j, u, v, c
-  const len = arr.length
   for (i = 0; i < len; i++) {
     const arrI = arr[i]
     if (arrI !== 0) {
-      j = result[result.length - 1]
+      j = result[length - 1]
       if (arr[j] < arrI) {
         p[i] = j
-        result.push(i)
+        result[length++] = i
         continue
       }
       u = 0
-      v = result.length - 1
+      v = length - 1
       while (u < v) {
         c = (u + v) >> 1
         if (arr[result[c]] < arrI) {
@@ -2471,11 +2665,11 @@ function getSequence(arr: number[]): number[] {
       }
     }
   }
-  u = result.length
+  u = length
   v = result[u - 1]
   while (u-- > 0) {
     result[u] = v
     v = p[v]
   }
-  return result
+  return length
 }
@@ -23,6 +23,31 @@ export interface SchedulerJob extends Function {
    * stabilizes (#1727).
    */
   allowRecurse?: boolean
+  /**
+   * Whether the job is in the queue, so that queueing it again is a no-op.
+   * Cleared right before the job runs.
+   * @internal
+   */
+  queued?: boolean
+  /**
+   * Attached by renderer.ts to the update jobs of components whose app
+   * enabled `app.config.timeSlicing`: once the flush has run for this many
+   * ms, it yields to the event loop after the job.
+   * @internal
+   */
+  budget?: number
+  /**
+   * The lane the job is flushed in, set by renderer.ts from the `lane`
+   * option of a component and by apiWatch.ts from the `lane` option of a
+   * watcher.
+   */
+  lane?: SchedulerLane
+  /**
+   * Set on watcher jobs queued in a lane, so that they run before the update
+   * of their component (which has the same id), see `flushPreJobs`.
+   * @internal
+   */
+  pre?: boolean
   /**
    * Attached by renderer.ts when setting up a component's render effect
    * Used to obtain component information when reporting max recursive updates.
@@ -33,6 +58,17 @@ export interface SchedulerJob extends Function {
 
 export type SchedulerJobs = SchedulerJob | SchedulerJob[]
 
+/**
+ * Priority of a component update or watcher in the queue, from highest to
+ * lowest:
+ * - `'immediate'`: never deferred by a time-sliced flush.
+ * - `'user-blocking'`: e.g. the update of an input the user is typing in.
+ * - `'normal'`: the default.
+ * - `'idle'`: e.g. an expensive chart. The flush yields to the event loop
+ *   before running idle jobs, so the browser can paint the other lanes first.
+ */
+export type SchedulerLane = 'immediate' | 'user-blocking' | 'normal' | 'idle'
+
 let isFlushing = false
 let isFlushPending = false
 
@@ -49,8 +85,34 @@ let isFlushPending = false
 // 是否允许插队	        不允许	                    允许	                                     不允许
 // job执行顺序	 按入队顺序执行，先进先出	   按job.id升序顺序执行job。保证父子组件的更新顺序	  按job.id升序顺序执行job
 
+// The queue is a binary min-heap ordered by lane, then by job id, then by
+// queueing order, so queueing and taking the next job are O(log n) no matter
+// how many jobs are queued. Jobs without an id run last within their lane,
+// in the order they were queued.
+// `queueLane` and `queueOrder` hold the lane and queueing sequence number of
+// each heap entry.
 const queue: SchedulerJob[] = []
-let flushIndex = 0
+const queueLane: Lane[] = []
+const queueOrder: number[] = []
+let queueSeq = 0
+
+const enum Lane {
+  IMMEDIATE,
+  USER_BLOCKING,
+  NORMAL,
+  IDLE
+}
+
+const laneMap: Record<SchedulerLane, Lane> = {
+  immediate: Lane.IMMEDIATE,
+  'user-blocking': Lane.USER_BLOCKING,
+  normal: Lane.NORMAL,
+  idle: Lane.IDLE
+}
+
+// the watcher jobs in the queue by component id, so that `flushPreJobs` can
+// run them before the update of their component when it comes first
+const queuedPreJobs = new Map<number, SchedulerJob[]>()
 
 const pendingPreFlushCbs: SchedulerJob[] = []
 let activePreFlushCbs: SchedulerJob[] | null = null
@@ -64,6 +126,18 @@ const resolvedPromise = /*#__PURE__*/ Promise.resolve() as Promise<any>
 let currentFlushPromise: Promise<void> | null = null
 
 let currentPreFlushParentJob: SchedulerJob | null = null
+let currentFlushJob: SchedulerJob | null = null
+let currentFlushLane = Lane.NORMAL
+// once a flush has yielded, `yieldSeq` is the queueing sequence number of
+// the first job queued after that, and `yieldedJobs` the number of heap
+// entries queued before it that are still in the queue
+let yieldSeq = -1
+let yieldedJobs = 0
+
+/**
+ * Flush budget in ms used when `app.config.timeSlicing` is `true`
+ */
+export const DEFAULT_FLUSH_BUDGET = 5
 
 const RECURSION_LIMIT = 100
 type CountMap = Map<SchedulerJob, number>
@@ -79,51 +153,110 @@ export function nextTick<T = void>(
   return fn ? p.then(this ? fn.bind(this) : fn) : p
 }
 
-// #2768
-// Use binary-search to find a suitable position in the queue,
-// so that the queue maintains the increasing order of job's id,
-// which can prevent the job from being skipped and also can avoid repeated patching.
-function findInsertionIndex(id: number) {
-  // the start index should be `flushIndex + 1`
-  let start = flushIndex + 1
-  let end = queue.length
-
-  while (start < end) {
-    const middle = (start + end) >>> 1
-    const middleJobId = getId(queue[middle])
-    middleJobId < id ? (start = middle + 1) : (end = middle)
+function isBefore(a: number, b: number) {
+  if (queueLane[a] !== queueLane[b]) {
+    return queueLane[a] < queueLane[b]
+  }
+  const jobA = queue[a]
+  const jobB = queue[b]
+  const idA = getId(jobA)
+  const idB = getId(jobB)
+  if (idA !== idB) {
+    return idA < idB
   }
+  if (!jobA.pre !== !jobB.pre) {
+    return !!jobA.pre
+  }
+  return queueOrder[a] < queueOrder[b]
+}
 
-  return start
+function swap(a: number, b: number) {
+  const job = queue[a]
+  queue[a] = queue[b]
+  queue[b] = job
+  const lane = queueLane[a]
+  queueLane[a] = queueLane[b]
+  queueLane[b] = lane
+  const order = queueOrder[a]
+  queueOrder[a] = queueOrder[b]
+  queueOrder[b] = order
 }
+
+function pushQueue(job: SchedulerJob, lane: Lane) {
+  let i = queue.length
+  queue.push(job)
+  queueLane.push(lane)
+  queueOrder.push(queueSeq++)
+  // sift up
+  while (i > 0) {
+    const parent = (i - 1) >> 1
+    if (!isBefore(i, parent)) break
+    swap(i, parent)
+    i = parent
+  }
+}
+
+function shiftQueue(): SchedulerJob {
+  const first = queue[0]
+  const lastJob = queue.pop()!
+  const lastLane = queueLane.pop()!
+  const lastOrder = queueOrder.pop()!
+  const length = queue.length
+  if (length) {
+    queue[0] = lastJob
+    queueLane[0] = lastLane
+    queueOrder[0] = lastOrder
+    // sift down
+    let i = 0
+    let child
+    while ((child = 2 * i + 1) < length) {
+      if (child + 1 < length && isBefore(child + 1, child)) child++
+      if (!isBefore(child, i)) break
+      swap(i, child)
+      i = child
+    }
+  }
+  return first
+}
+
+// Normal jobs queued by higher lane jobs are promoted to the user-blocking
+// lane. Jobs with an explicit lane keep it.
+function getLane(job: SchedulerJob): Lane {
+  const lane = job.lane ? laneMap[job.lane] : Lane.NORMAL
+  if (lane !== Lane.NORMAL) {
+    return lane
+  }
+  return currentFlushLane < Lane.NORMAL ? Lane.USER_BLOCKING : Lane.NORMAL
+}
+
 // queue队列入队
 export function queueJob(job: SchedulerJob) {
-  // the dedupe search uses the startIndex argument of Array.includes()
-  // by default the search index includes the current job that is being run
-  // so it cannot recursively trigger itself again.
-  // if the job is a watch() callback, the search will start with a +1 index to
-  // allow it recursively trigger itself - it is the user's responsibility to
-  // ensure it doesn't end up in an infinite loop.
-  // 当满足以下情况中的一种才可以入队
-  // 1. queue长度为0
-  // 2. queue中不存在job（如果job是watch()回调，搜索从flushIndex + 1开始，
-  // 否则从flushIndex开始），并且job不等于currentPreFlushParentJob
+  // the dedupe check uses the `queued` flag of the job. By default the job
+  // that is being run is also skipped, so it cannot recursively trigger
+  // itself again.
+  // if the job is a watch() callback, it is allowed to recursively trigger
+  // itself - it is the user's responsibility to ensure it doesn't end up in
+  // an infinite loop.
+  // 当满足以下情况才可以入队
+  // 1. job不在queue中（queued标记为false）
+  // 2. job不是正在执行的job，除非job允许递归（allowRecurse）
+  // 3. job不等于currentPreFlushParentJob
   if (
-    (!queue.length ||
-      !queue.includes(
-        job,
-        isFlushing && job.allowRecurse ? flushIndex + 1 : flushIndex
-      )) &&
+    !job.queued &&
+    (job !== currentFlushJob || job.allowRecurse) &&
     job !== currentPreFlushParentJob
   ) {
-    // job.id为null直接入队
-    if (job.id == null) {
-      queue.push(job)
-    } else {
-      // 插队，插队后queue索引区间[flushIndex + 1, end]内的job.id是非递减的
-      // findInsertionIndex方法通过二分法寻找[flushIndex + 1, end]区间内大于等于job.id的第一个索引
-      queue.splice(findInsertionIndex(job.id), 0, job)
+    job.queued = true
+    if (job.pre) {
+      const jobs = queuedPreJobs.get(getId(job))
+      if (jobs) {
+        jobs.push(job)
+      } else {
+        queuedPreJobs.set(getId(job), [job])
+      }
     }
+    // 按lane及job.id入堆，没有id的job排在所在lane的最后
+    pushQueue(job, getLane(job))
     queueFlush()
   }
 }
@@ -143,11 +276,10 @@ function queueFlush() {
   // 才能执行queueJob，这样以来flushJobs的执行就会非常靠后。
 }
 
+// the heap entry of an invalidated job is skipped when it is taken from the
+// queue, unless the job was queued again in the meantime
 export function invalidateJob(job: SchedulerJob) {
-  const i = queue.indexOf(job)
-  if (i > flushIndex) {
-    queue.splice(i, 1)
-  }
+  job.queued = false
 }
 
 function queueCb(
@@ -224,6 +356,54 @@ export function flushPreFlushCbs(
   }
 }
 
+/**
+ * Runs the queued watcher jobs of the component with the given id, right
+ * before it is updated. They would be taken from the queue before the update
+ * anyway if they are in the same lane, but not if they are in a lower lane or
+ * if the update is run by the parent component.
+ */
+export function flushPreJobs(id: number, seen?: CountMap) {
+  if (!queuedPreJobs.size) {
+    return
+  }
+  if (__DEV__) {
+    seen = seen || new Map()
+  }
+  // jobs queued again by the watchers are run in the next iteration
+  let jobs: SchedulerJob[] | undefined
+  while ((jobs = queuedPreJobs.get(id))) {
+    queuedPreJobs.delete(id)
+    for (let i = 0; i < jobs.length; i++) {
+      const job = jobs[i]
+      // invalidated, or listed twice after being invalidated and queued again
+      if (!job.queued) {
+        continue
+      }
+      // the heap entry is skipped
+      job.queued = false
+      if (__DEV__ && checkRecursiveUpdates(seen!, job)) {
+        continue
+      }
+      job()
+    }
+  }
+}
+
+function removePreJob(job: SchedulerJob) {
+  const id = getId(job)
+  const jobs = queuedPreJobs.get(id)
+  if (jobs) {
+    const i = jobs.indexOf(job)
+    if (i > -1) {
+      if (jobs.length === 1) {
+        queuedPreJobs.delete(id)
+      } else {
+        jobs.splice(i, 1)
+      }
+    }
+  }
+}
+
 export function flushPostFlushCbs(seen?: CountMap) {
   // 存在job才执行
   if (pendingPostFlushCbs.length) {
@@ -270,7 +450,8 @@ const getId = (job: SchedulerJob): number =>
 
 // 在flushJobs中会依次执行pendingPreFlushCbs、queue、pendingPostFlushCbs中的任务，
 // 如果此时还有剩余job，则继续执行flushJobs，直到将三个队列中的任务都执行完。
-function flushJobs(seen?: CountMap) {
+function flushJobs(seen?: CountMap): Promise<void> | void {
+  const sliceStart = now()
   // 将isFlushPending置为false，isFlushing置为true
   // 因为此时已经要开始执行队列了
   isFlushPending = false
@@ -281,7 +462,7 @@ function flushJobs(seen?: CountMap) {
   // 执行前置任务队列
   flushPreFlushCbs(seen)
 
-  // Sort queue before flush.
+  // The queue is ordered by job id.
   // This ensures that:
   // 1. Components are updated from parent to child. (because parent is always
   //    created before the child so its render effect will have smaller
@@ -292,7 +473,6 @@ function flushJobs(seen?: CountMap) {
   // 这可确保：
   // 1. 组件从父组件先更新然后子组件更新。（因为 parent 总是在 child 之前创建，所以它的redner effect会具有较高的优先级）
   // 2. 如果在 parent 组件更新期间卸载组件，则可以跳过其更新
-  queue.sort((a, b) => getId(a) - getId(b))
 
   // conditional usage of checkRecursiveUpdate must be determined out of
   // try ... catch block since Rollup by default de-optimizes treeshaking
@@ -304,41 +484,149 @@ function flushJobs(seen?: CountMap) {
     ? (job: SchedulerJob) => checkRecursiveUpdates(seen!, job)
     : NOOP
 
+  // a time-sliced flush that yielded, or the flush of jobs queued by
+  // post-flush callbacks
+  let pending: Promise<void> | void
+  let yielded = false
+  // whether the flush ends before the queue is empty, see below
+  let split = false
+
   // 执行queue中的任务
   try {
-    for (flushIndex = 0; flushIndex < queue.length; flushIndex++) {
-      const job = queue[flushIndex]
-      if (job && job.active !== false) {
+    while (queue.length) {
+      // once the jobs queued before the flush yielded have run, the flush
+      // ends so that jobs queued meanwhile (e.g. by event handlers that keep
+      // firing) cannot hold back post-flush callbacks and `nextTick()`. The
+      // rest of the queue is flushed right after
+      if (yieldSeq >= 0 && !yieldedJobs) {
+        split = true
+        break
+      }
+      const lane = queueLane[0]
+      if (queueOrder[0] < yieldSeq) {
+        yieldedJobs--
+      }
+      const job = shiftQueue()
+      // invalidated after it was queued
+      if (!job.queued) {
+        continue
+      }
+      job.queued = false
+      if (job.pre) {
+        removePreJob(job)
+      }
+      if (job.active !== false) {
         if (__DEV__ && check(job)) {
           continue
         }
+        currentFlushJob = job
+        currentFlushLane = lane
         // console.log(`running:`, job.id)
         callWithErrorHandling(job, null, ErrorCodes.SCHEDULER)
+        currentFlushJob = null
+        // yield to the event loop before the idle lane, and in a time-sliced
+        // flush once the budget is spent. The rest of the queue is flushed
+        // in a later task
+        if (
+          queue.length &&
+          ((queueLane[0] === Lane.IDLE && lane !== Lane.IDLE) ||
+            (job.budget &&
+              queueLane[0] !== Lane.IMMEDIATE &&
+              now() - sliceStart >= job.budget))
+        ) {
+          yielded = true
+          if (yieldSeq < 0) {
+            yieldSeq = queueSeq
+            yieldedJobs = queue.length
+          }
+          break
+        }
       }
     }
   } finally {
-    // 清空queue并将flushIndex重置为0
-    flushIndex = 0
-    queue.length = 0
-
-    // 执行后置任务队列
-    flushPostFlushCbs(seen)
-
-    // 将isFlushing置为false，说明此时任务已经执行完
-    isFlushing = false
-    currentFlushPromise = null
-    // some postFlushCb queued jobs!
-    // keep flushing until it drains.
-    // 执行剩余job
-    // post队列执行过程中可能有job加入，继续调用flushJobs执行剩余job
-    if (
-      queue.length ||
-      pendingPreFlushCbs.length ||
-      pendingPostFlushCbs.length
-    ) {
-      flushJobs(seen)
+    currentFlushJob = null
+    currentFlushLane = Lane.NORMAL
+    if (!yielded) {
+      yieldSeq = -1
+      if (!split) {
+        // 清空queue，重置未执行job的queued标记
+        for (let i = 0; i < queue.length; i++) {
+          queue[i].queued = false
+        }
+        queue.length = 0
+        queueLane.length = 0
+        queueOrder.length = 0
+        queuedPreJobs.clear()
+      }
+
+      // 执行后置任务队列
+      flushPostFlushCbs(seen)
+
+      // 将isFlushing置为false，说明此时任务已经执行完
+      isFlushing = false
+      currentFlushPromise = null
+      // some postFlushCb queued jobs!
+      // keep flushing until it drains.
+      // 执行剩余job
+      // post队列执行过程中可能有job加入，继续调用flushJobs执行剩余job
+      if (split) {
+        // in a new flush, which `nextTick()` calls made so far do not wait for
+        queueFlush()
+      } else if (
+        queue.length ||
+        pendingPreFlushCbs.length ||
+        pendingPostFlushCbs.length
+      ) {
+        pending = flushJobs(seen)
+      }
     }
   }
+  return yielded ? yieldFlush() : pending
+}
+
+// Continues a time-sliced flush in a later task. The flush stays in
+// progress meanwhile, so jobs queued by event handlers are added to the
+// queue, and `nextTick()` resolves once the jobs queued before the yield have
+// been flushed. Recursive updates are counted per slice, since a component
+// may legitimately update many times during a long flush (e.g. while typing).
+function yieldFlush(): Promise<void> {
+  return (currentFlushPromise = new Promise((resolve, reject) => {
+    scheduleTask(() => {
+      try {
+        resolve(flushJobs())
+      } catch (err) {
+        reject(err)
+      }
+    })
+  }))
+}
+
+const now: () => number =
+  typeof performance !== 'undefined' && performance.now
+    ? () => performance.now()
+    : Date.now
+
+let channel: MessageChannel | undefined
+let channelTask: (() => void) | undefined
+
+// schedules a macrotask, so that the browser can handle input events and
+// paint before it runs
+function scheduleTask(task: () => void) {
+  if (typeof setImmediate === 'function') {
+    // Node.js and legacy IE. Unlike a MessageChannel, it doesn't keep a
+    // Node.js process alive
+    setImmediate(task)
+  } else if (typeof MessageChannel !== 'undefined') {
+    // not clamped to 4ms when nested, unlike setTimeout
+    if (!channel) {
+      channel = new MessageChannel()
+      channel.port1.onmessage = () => channelTask!()
+    }
+    channelTask = task
+    channel.port2.postMessage(null)
+  } else {
+    setTimeout(task)
+  }
 }
 
 function checkRecursiveUpdates(seen: CountMap, fn: SchedulerJob) {
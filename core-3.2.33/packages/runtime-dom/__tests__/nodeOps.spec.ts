@@ -26,6 +26,16 @@ describe('runtime-dom: node-ops', () => {
     expect(option2.selected).toBe(true)
   })
 
+  test('insertMany', () => {
+    const parent = document.createElement('div')
+    parent.innerHTML = `<a></a><b></b><i></i>`
+    const [a, b, i] = Array.from(parent.childNodes)
+    nodeOps.insertMany!([i, b], parent, a)
+    expect(parent.innerHTML).toBe(`<i></i><b></b><a></a>`)
+    nodeOps.insertMany!([a, i], parent, null)
+    expect(parent.innerHTML).toBe(`<b></b><a></a><i></i>`)
+  })
+
   describe('insertStaticContent', () => {
     test('fresh insertion', () => {
       const content = `<div>one</div><div>two</div>three`
@@ -12,6 +12,14 @@ export const nodeOps: Omit<RendererOptions<Node, Element>, 'patchProp'> = {
   insert: (child, parent, anchor) => {
     parent.insertBefore(child, anchor || null)
   },
+  // inserts a run of nodes with a single DOM mutation of the parent
+  insertMany: (children, parent, anchor) => {
+    const fragment = doc.createDocumentFragment()
+    for (let i = 0; i < children.length; i++) {
+      fragment.appendChild(children[i])
+    }
+    parent.insertBefore(fragment, anchor || null)
+  },
   //删除节点
   remove: child => {
     const parent = child.parentNode
@@ -166,6 +166,16 @@ function insert(child: TestNode, parent: TestElement, ref?: TestNode | null) {
   }
 }
 
+function insertMany(
+  children: TestNode[],
+  parent: TestElement,
+  ref?: TestNode | null
+) {
+  for (let i = 0; i < children.length; i++) {
+    insert(children[i], parent, ref)
+  }
+}
+
 function remove(child: TestNode, logOp = true) {
   const parent = child.parentNode
   if (parent) {
@@ -234,6 +244,7 @@ function setScopeId(el: TestElement, id: string) {
 
 export const nodeOps = {
   insert,
+  insertMany,
   remove,
   createElement,
   createText,
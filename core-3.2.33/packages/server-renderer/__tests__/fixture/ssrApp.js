@@ -0,0 +1,14 @@
+// app factory rendered by the worker pool in ssrWorkerPool.spec.ts
+const { createSSRApp, h, Teleport, useSSRContext } = require('vue')
+
+module.exports = context =>
+  createSSRApp({
+    setup() {
+      useSSRContext().modules.add(`${context.url}.vue`)
+      return () =>
+        h('div', [
+          'hello',
+          h(Teleport, { to: '#modal' }, h('span', context.url))
+        ])
+    }
+  })
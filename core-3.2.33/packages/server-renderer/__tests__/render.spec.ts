@@ -65,6 +65,19 @@ testRender(`renderToString`, renderToString)
 testRender(`renderToNodeStream`, renderToStream)
 testRender(`pipeToNodeWritable`, pipeToWritable)
 
+describe('ssr: renderToNodeStream', () => {
+  test('reading while content is pending', async () => {
+    const app = createApp({
+      async setup() {
+        await new Promise(r => setTimeout(r, 10))
+        return () => h('div', 'foo')
+      }
+    })
+    // the stream is read before anything is pushed
+    expect(await renderToStream(app)).toBe(`<div>foo</div>`)
+  })
+})
+
 function testRender(type: string, render: typeof renderToString) {
   describe(`ssr: ${type}`, () => {
     test('should apply app context', async () => {
@@ -1049,6 +1062,45 @@ function testRender(type: string, render: typeof renderToString) {
       expect(html).toBe(`<div>foobarbaz</div>`)
     })
 
+    describe('concurrent serverPrefetch', () => {
+      let active: number
+      let maxActive: number
+      const Widget = defineComponent({
+        props: ['n'],
+        data: () => ({ msg: '' }),
+        async serverPrefetch() {
+          maxActive = Math.max(maxActive, ++active)
+          await new Promise(r => setTimeout(r, 10))
+          active--
+          this.msg = `w${this.n}`
+        },
+        render() {
+          return h('span', this.msg)
+        }
+      })
+      const createWidgets = () =>
+        createApp({
+          render: () => h('div', [1, 2, 3, 4].map(n => h(Widget, { n })))
+        })
+      const html = `<div><span>w1</span><span>w2</span><span>w3</span><span>w4</span></div>`
+
+      beforeEach(() => {
+        active = maxActive = 0
+      })
+
+      test('independent siblings are loaded in parallel', async () => {
+        expect(await render(createWidgets())).toBe(html)
+        expect(maxActive).toBe(4)
+      })
+
+      test('maxConcurrentPrefetches', async () => {
+        expect(
+          await render(createWidgets(), { maxConcurrentPrefetches: 2 })
+        ).toBe(html)
+        expect(maxActive).toBe(2)
+      })
+    })
+
     test('onServerPrefetch throwing error', async () => {
       let renderError: Error | null = null
       let capturedError: Error | null = null
@@ -0,0 +1,124 @@
+/**
+ * @jest-environment node
+ */
+
+import { createApp } from 'vue'
+import { existsSync, mkdtempSync, readdirSync, rmSync } from 'fs'
+import { tmpdir } from 'os'
+import { join } from 'path'
+import { renderToString } from '../src/renderToString'
+import {
+  configureSSRCompileCache,
+  getSSRCompileCacheStats
+} from '../src/helpers/ssrCompile'
+
+describe('ssr: compile cache', () => {
+  afterEach(() => {
+    configureSSRCompileCache()
+  })
+
+  test('reuses compiled templates', async () => {
+    configureSSRCompileCache()
+    const render = () =>
+      renderToString(createApp({ template: `<div>cached</div>` }))
+
+    expect(await render()).toBe(`<div>cached</div>`)
+    expect(await render()).toBe(`<div>cached</div>`)
+    const stats = getSSRCompileCacheStats()
+    expect(stats.compiles).toBe(1)
+    expect(stats.misses).toBe(1)
+    expect(stats.hits).toBe(1)
+    expect(stats.length).toBe(1)
+    expect(stats.compileTime).toBeGreaterThan(0)
+  })
+
+  test('compiler options are part of the key', async () => {
+    configureSSRCompileCache()
+    const template = `<div>a   b</div>`
+    expect(await renderToString(createApp({ template }))).toBe(
+      `<div>a b</div>`
+    )
+    expect(
+      await renderToString(
+        createApp({ template, compilerOptions: { whitespace: 'preserve' } })
+      )
+    ).toBe(`<div>a   b</div>`)
+    expect(getSSRCompileCacheStats().compiles).toBe(2)
+  })
+
+  test('app compiler options are compared by value', async () => {
+    configureSSRCompileCache()
+    const render = (compilerOptions: object) => {
+      const app = createApp({ template: `<div>a   b</div>` })
+      app.config.compilerOptions = compilerOptions
+      return renderToString(app)
+    }
+
+    expect(await render({ whitespace: 'preserve' })).toBe(`<div>a   b</div>`)
+    expect(await render({ whitespace: 'preserve' })).toBe(`<div>a   b</div>`)
+    expect(getSSRCompileCacheStats().compiles).toBe(1)
+    expect(await render({})).toBe(`<div>a b</div>`)
+    expect(await render({ whitespace: 'preserve' })).toBe(`<div>a   b</div>`)
+    const stats = getSSRCompileCacheStats()
+    expect(stats.compiles).toBe(2)
+    expect(stats.hits).toBe(2)
+  })
+
+  test('evicts least recently used templates', async () => {
+    configureSSRCompileCache({ max: 2 })
+    for (const tag of ['p', 'span', 'em', 'p']) {
+      await renderToString(createApp({ template: `<${tag}></${tag}>` }))
+    }
+    const stats = getSSRCompileCacheStats()
+    expect(stats.length).toBe(2)
+    expect(stats.evictions).toBe(2)
+    expect(stats.compiles).toBe(4)
+  })
+
+  test('size limit', async () => {
+    configureSSRCompileCache({ maxSize: 1 })
+    await renderToString(createApp({ template: `<div></div>` }))
+    expect(getSSRCompileCacheStats().length).toBe(0)
+  })
+
+  test('persists compiled code to cacheDir', async () => {
+    const cacheDir = mkdtempSync(join(tmpdir(), 'vue-ssr-compile-'))
+    try {
+      const template = `<section>persisted</section>`
+      configureSSRCompileCache({ cacheDir })
+      await renderToString(createApp({ template }))
+      expect(getSSRCompileCacheStats().compiles).toBe(1)
+
+      // written asynchronously
+      const written = () =>
+        readdirSync(cacheDir).filter(f => f.endsWith('.js')).length
+      for (let i = 0; i < 50 && !written(); i++) {
+        await new Promise(r => setTimeout(r, 10))
+      }
+      expect(written()).toBe(1)
+
+      // a fresh cache (e.g. a new worker) reads the code back from disk
+      configureSSRCompileCache({ cacheDir })
+      expect(await renderToString(createApp({ template }))).toBe(
+        `<section>persisted</section>`
+      )
+      const stats = getSSRCompileCacheStats()
+      expect(stats.compiles).toBe(0)
+      expect(stats.diskHits).toBe(1)
+    } finally {
+      rmSync(cacheDir, { recursive: true, force: true })
+    }
+  })
+
+  test('ignores cacheDir outside of the Node.js build', () => {
+    const cacheDir = join(tmpdir(), `vue-ssr-compile-${Date.now()}`)
+    __NODE_JS__ = false
+    try {
+      configureSSRCompileCache({ cacheDir })
+    } finally {
+      __NODE_JS__ = true
+    }
+    expect(existsSync(cacheDir)).toBe(false)
+    expect(`cacheDir option is only supported`).toHaveBeenWarned()
+  })
+})
@@ -0,0 +1,216 @@
+/**
+ * @jest-environment node
+ */
+
+import {
+  createApp,
+  h,
+  defineComponent,
+  Teleport,
+  useSSRContext
+} from 'vue'
+import { renderToString } from '../src/renderToString'
+import { createSSRComponentCache } from '../src/componentCache'
+import { SSRContext } from '../src/render'
+
+describe('ssr: component cache', () => {
+  const setup = jest.fn()
+  const Card = defineComponent({
+    name: 'Card',
+    props: ['id'],
+    serverCacheKey: props => props.id as string,
+    setup(props) {
+      setup()
+      return () => h('div', { class: 'card' }, `card ${props.id}`)
+    }
+  })
+
+  beforeEach(() => {
+    setup.mockClear()
+  })
+
+  test('skips setup and render on hit', async () => {
+    const cache = createSSRComponentCache()
+    const app = () =>
+      createApp({
+        render: () => h('main', [h(Card, { id: 'a' }), h(Card, { id: 'b' })])
+      })
+
+    const html = `<main><div class="card">card a</div><div class="card">card b</div></main>`
+    expect(await renderToString(app(), { componentCache: cache })).toBe(html)
+    expect(setup).toHaveBeenCalledTimes(2)
+    expect(await renderToString(app(), { componentCache: cache })).toBe(html)
+    expect(setup).toHaveBeenCalledTimes(2)
+
+    expect(cache.hits).toBe(2)
+    expect(cache.misses).toBe(2)
+    expect(cache.length).toBe(2)
+  })
+
+  test('renders normally without a store in the context', async () => {
+    const app = () => createApp({ render: () => h(Card, { id: 'a' }) })
+    await renderToString(app())
+    await renderToString(app())
+    expect(setup).toHaveBeenCalledTimes(2)
+  })
+
+  test('falsy key skips the cache', async () => {
+    const cache = createSSRComponentCache()
+    const Comp = {
+      name: 'Comp',
+      serverCacheKey: () => false as const,
+      render: () => h('div', 'foo')
+    }
+    const app = createApp({ render: () => h(Comp) })
+    await renderToString(app, { componentCache: cache })
+    expect(cache.length).toBe(0)
+    expect(cache.misses).toBe(0)
+  })
+
+  test('async subtree', async () => {
+    const cache = createSSRComponentCache()
+    const Async = defineComponent({
+      name: 'Async',
+      serverCacheKey: () => 'x',
+      async setup() {
+        setup()
+        await new Promise(r => setTimeout(r))
+        return () => h('div', [h(Card, { id: 'c' })])
+      }
+    })
+    const app = () => createApp({ render: () => h(Async) })
+    const html = `<div><div class="card">card c</div></div>`
+    expect(await renderToString(app(), { componentCache: cache })).toBe(html)
+    expect(setup).toHaveBeenCalledTimes(2)
+    expect(cache.length).toBe(2)
+    expect(await renderToString(app(), { componentCache: cache })).toBe(html)
+    expect(setup).toHaveBeenCalledTimes(2)
+  })
+
+  test('entries are keyed by component name', async () => {
+    const cache = createSSRComponentCache()
+    const Child = {
+      name: 'Child',
+      serverCacheKey: () => 'x',
+      render: () => h('div')
+    }
+    const app = createApp({ render: () => h(Child) })
+    await renderToString(app, { componentCache: cache })
+    expect(cache.get('Child::x')).toBe(`<div></div>`)
+  })
+
+  test('entries are keyed by inherited scope ids', async () => {
+    const cache = createSSRComponentCache()
+    const Child = {
+      name: 'Child',
+      serverCacheKey: () => 'x',
+      render: () => h('div')
+    }
+    // renders Child as its root, so Child inherits the scope id of Outer
+    const Wrapper = { render: () => h(Child) }
+    const Scoped = { __scopeId: 'data-v-scoped', render: () => h(Child) }
+    const Outer = { __scopeId: 'data-v-outer', render: () => h(Wrapper) }
+    const render = (comp: object) =>
+      renderToString(createApp(comp), { componentCache: cache })
+
+    expect(await render(Scoped)).toBe(`<div data-v-scoped></div>`)
+    expect(await render(Outer)).toBe(`<div data-v-outer></div>`)
+    expect(await render(Wrapper)).toBe(`<div></div>`)
+    expect(await render(Scoped)).toBe(`<div data-v-scoped></div>`)
+    expect(cache.get('Child::x::data-v-scoped')).toBe(
+      `<div data-v-scoped></div>`
+    )
+    expect(cache.get('Child::x::data-v-outer')).toBe(`<div data-v-outer></div>`)
+    expect(cache.get('Child::x')).toBe(`<div></div>`)
+  })
+
+  test('components rendering teleports are not cached', async () => {
+    const cache = createSSRComponentCache()
+    const Modal = {
+      name: 'Modal',
+      serverCacheKey: () => 'x',
+      render: () => h('div', [h(Teleport, { to: 'body' }, h('span', 'hi'))])
+    }
+    const app = () =>
+      createApp({ render: () => h('main', [h(Modal), h(Card, { id: 'a' })]) })
+    for (let i = 0; i < 2; i++) {
+      const context: SSRContext = { componentCache: cache }
+      await renderToString(app(), context)
+      expect(context.teleports).toEqual({ body: `<span>hi</span><!---->` })
+    }
+    expect(cache.get('Modal::x')).toBeUndefined()
+    expect(cache.get('Card::a')).toBe(`<div class="card">card a</div>`)
+  })
+
+  // only the HTML is cached
+  test('modules are not collected on hits', async () => {
+    const cache = createSSRComponentCache()
+    const Comp = {
+      name: 'Comp',
+      serverCacheKey: () => 'x',
+      setup() {
+        useSSRContext()!.modules.add('Comp.vue')
+        return () => h('div')
+      }
+    }
+    const render = async () => {
+      const context: SSRContext = { componentCache: cache, modules: new Set() }
+      await renderToString(createApp(Comp), context)
+      return context.modules
+    }
+    expect(await render()).toEqual(new Set(['Comp.vue']))
+    expect(await render()).toEqual(new Set())
+  })
+
+  test('warns for components without a name', async () => {
+    const cache = createSSRComponentCache()
+    const app = createApp({
+      render: () => h({ serverCacheKey: () => 'x', render: () => h('div') })
+    })
+    expect(await renderToString(app, { componentCache: cache })).toBe(
+      `<div></div>`
+    )
+    expect(cache.length).toBe(0)
+    expect(`must also have a unique name option`).toHaveBeenWarned()
+  })
+
+  describe('createSSRComponentCache', () => {
+    test('evicts least recently used entries', () => {
+      const cache = createSSRComponentCache({ max: 2 })
+      cache.set('a', 'a')
+      cache.set('b', 'b')
+      cache.get('a')
+      cache.set('c', 'c')
+      expect(cache.get('b')).toBeUndefined()
+      expect(cache.get('a')).toBe('a')
+      expect(cache.get('c')).toBe('c')
+      expect(cache.evictions).toBe(1)
+      expect(cache.hits).toBe(3)
+      expect(cache.misses).toBe(1)
+    })
+
+    test('byte size limit', () => {
+      const cache = createSSRComponentCache({ maxSize: 10 })
+      cache.set('a', 'aaaa')
+      cache.set('b', 'é€') // 2 + 3 bytes
+      expect(cache.size).toBe(9)
+      cache.set('c', '😀') // 4 bytes
+      expect(cache.size).toBe(9)
+      expect(cache.get('a')).toBeUndefined()
+      // entries larger than the limit are never stored
+      cache.set('d', 'x'.repeat(11))
+      expect(cache.get('d')).toBeUndefined()
+      expect(cache.length).toBe(2)
+    })
+
+    test('replacing and deleting entries', () => {
+      const cache = createSSRComponentCache()
+      cache.set('a', 'aa')
+      cache.set('a', 'a')
+      expect(cache.size).toBe(1)
+      expect(cache.delete('a')).toBe(true)
+      expect(cache.delete('a')).toBe(false)
+      expect(cache.size).toBe(0)
+    })
+  })
+})
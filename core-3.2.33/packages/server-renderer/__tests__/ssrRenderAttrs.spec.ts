@@ -6,7 +6,8 @@ import {
   ssrRenderAttrs,
   ssrRenderClass,
   ssrRenderStyle,
-  ssrRenderAttr
+  ssrRenderAttr,
+  ssrRenderDynamicAttrs
 } from '../src/helpers/ssrRenderAttrs'
 import { escapeHtml } from '@vue/shared'
 
@@ -100,6 +101,43 @@ describe('ssr: renderAttrs', () => {
   })
 })
 
+describe('ssr: renderDynamicAttrs', () => {
+  const staticProps = { id: 'foo', class: 'bar' }
+  const staticAttrs = ` id="foo" class="bar"`
+
+  test('prepends pre-serialized static attrs', () => {
+    expect(
+      ssrRenderDynamicAttrs(
+        { title: 'baz', onClick: () => {} },
+        staticProps,
+        staticAttrs
+      )
+    ).toBe(` id="foo" class="bar" title="baz"`)
+    expect(ssrRenderDynamicAttrs({}, staticProps, staticAttrs)).toBe(
+      staticAttrs
+    )
+  })
+
+  test('merges when a static attr is overridden', () => {
+    expect(
+      ssrRenderDynamicAttrs(
+        { class: { qux: true }, id: 'baz' },
+        staticProps,
+        staticAttrs
+      )
+    ).toBe(` id="baz" class="bar qux"`)
+    expect(
+      ssrRenderDynamicAttrs({ id: undefined }, staticProps, staticAttrs)
+    ).toBe(` class="bar"`)
+  })
+
+  test('passes tag through', () => {
+    expect(
+      ssrRenderDynamicAttrs({ fooBar: 'ok' }, {}, ` x="y"`, 'my-el')
+    ).toBe(` x="y" fooBar="ok"`)
+  })
+})
+
 describe('ssr: renderAttr', () => {
   test('basic', () => {
     expect(ssrRenderAttr('foo', 'bar')).toBe(` foo="bar"`)
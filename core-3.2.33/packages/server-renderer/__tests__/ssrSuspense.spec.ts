@@ -2,8 +2,16 @@
  * @jest-environment node
  */
 
-import { createApp, h, Suspense } from 'vue'
+import { createApp, h, Suspense, App } from 'vue'
 import { renderToString } from '../src/renderToString'
+import {
+  renderToSimpleStream,
+  SSRStreamOptions
+} from '../src/renderToStream'
+import { ssrRenderSuspense } from '../src/helpers/ssrRenderSuspense'
+import { ssrRenderComponent } from '../src/helpers/ssrRenderComponent'
+import { createSSRComponentCache } from '../src/componentCache'
+import { SSRContext } from '../src/render'
 
 describe('SSR Suspense', () => {
   const ResolvingAsync = {
@@ -130,4 +138,212 @@ describe('SSR Suspense', () => {
     expect(Comp.errorCaptured).toHaveBeenCalledTimes(1)
     expect('missing template').toHaveBeenWarned()
   })
+
+  describe('out-of-order streaming', () => {
+    function stream(
+      app: App,
+      context: SSRContext = {},
+      options: SSRStreamOptions = {}
+    ) {
+      let html = ''
+      const done = new Promise<void>((resolve, reject) => {
+        renderToSimpleStream(
+          app,
+          context,
+          {
+            push(chunk) {
+              chunk == null ? resolve() : (html += chunk)
+            },
+            destroy: reject
+          },
+          { outOfOrder: true, ...options }
+        )
+      })
+      return { done, read: () => html }
+    }
+
+    function deferred() {
+      let resolve!: () => void
+      const promise = new Promise<void>(r => (resolve = r))
+      return { promise, resolve }
+    }
+
+    const tick = () => new Promise(r => setTimeout(r))
+
+    const createAsync = (msg: string, wait: Promise<void>) => ({
+      async setup() {
+        await wait
+        return () => h('div', msg)
+      }
+    })
+
+    test('does not block on pending boundaries', async () => {
+      const slow = deferred()
+      const Comp = {
+        render: () => [
+          h('header', 'head'),
+          h(Suspense, null, {
+            default: h(createAsync('async', slow.promise)),
+            fallback: h('p', 'loading')
+          }),
+          h('footer', 'foot')
+        ]
+      }
+      const { done, read } = stream(createApp(Comp))
+      await tick()
+      expect(read()).toBe(
+        `<!--[--><header>head</header>` +
+          `<!--$?--><template id="vb:0"></template><p>loading</p><!--/$-->` +
+          `<footer>foot</footer><!--]-->`
+      )
+
+      slow.resolve()
+      await done
+      const rest = read().slice(read().indexOf(`<!--]-->`) + 8)
+      expect(rest).toMatch(
+        /^<template id="vc:0"><div>async<\/div><\/template><script>function \$vs\(.*\$vs\(0\)<\/script>$/
+      )
+    })
+
+    test('streams boundaries in the order they resolve', async () => {
+      const a = deferred()
+      const b = deferred()
+      const Comp = {
+        render: () => [
+          h(Suspense, null, { default: h(createAsync('a', a.promise)) }),
+          h(Suspense, null, { default: h(createAsync('b', b.promise)) })
+        ]
+      }
+      const { done, read } = stream(createApp(Comp))
+      b.resolve()
+      await tick()
+      expect(read()).toMatch(`<template id="vc:1"><div>b</div></template>`)
+      expect(read()).not.toMatch(`vc:0`)
+      a.resolve()
+      await done
+      expect(read()).toMatch(`<template id="vc:0"><div>a</div></template>`)
+      // the swap script is only sent once
+      expect(read().match(/function \$vs/g)!.length).toBe(1)
+    })
+
+    test('inlines boundaries that resolve synchronously', async () => {
+      const Comp = {
+        render: () =>
+          h(Suspense, null, {
+            default: h('div', 'sync'),
+            fallback: h('p', 'loading')
+          })
+      }
+      const { done, read } = stream(createApp(Comp))
+      await done
+      expect(read()).toBe(`<div>sync</div>`)
+    })
+
+    test('nested boundaries', async () => {
+      const outer = deferred()
+      const inner = deferred()
+      const Inner = createAsync('inner', inner.promise)
+      const Outer = {
+        async setup() {
+          await outer.promise
+          return () =>
+            h('section', [
+              h(Suspense, null, {
+                default: h(Inner),
+                fallback: h('p', 'loading inner')
+              })
+            ])
+        }
+      }
+      const Comp = {
+        render: () =>
+          h(Suspense, null, {
+            default: h(Outer),
+            fallback: h('p', 'loading outer')
+          })
+      }
+      const { done, read } = stream(createApp(Comp))
+      outer.resolve()
+      await tick()
+      expect(read()).toMatch(
+        `<template id="vc:0"><section>` +
+          `<!--$?--><template id="vb:1"></template><p>loading inner</p><!--/$-->` +
+          `</section></template>`
+      )
+      inner.resolve()
+      await done
+      expect(read()).toMatch(`<template id="vc:1"><div>inner</div></template>`)
+    })
+
+    test('compiled slots', async () => {
+      const slow = deferred()
+      const Async = createAsync('async', slow.promise)
+      const Comp = {
+        ssrRender(_ctx: any, push: any, parent: any) {
+          ssrRenderSuspense(
+            push,
+            {
+              default: push => {
+                push(ssrRenderComponent(Async, null, null, parent))
+              },
+              fallback: push => {
+                push(`<p>loading</p>`)
+              }
+            },
+            parent
+          )
+        }
+      }
+      const { done, read } = stream(createApp(Comp))
+      await tick()
+      expect(read()).toBe(
+        `<!--$?--><template id="vb:0"></template><p>loading</p><!--/$-->`
+      )
+      slow.resolve()
+      await done
+      expect(read()).toMatch(`<template id="vc:0"><div>async</div></template>`)
+    })
+
+    test('script nonce', async () => {
+      const Comp = {
+        render: () =>
+          h(Suspense, null, { default: h(createAsync('a', Promise.resolve())) })
+      }
+      const { done, read } = stream(createApp(Comp), {}, { nonce: 'n"1' })
+      await done
+      expect(read()).toMatch(`<script nonce="n&quot;1">function $vs(`)
+      expect(read()).not.toMatch(`<script>`)
+    })
+
+    // the boundary content is not part of the cached HTML
+    test('components with pending boundaries are not cached', async () => {
+      const componentCache = createSSRComponentCache()
+      const Card = {
+        name: 'Card',
+        serverCacheKey: () => 'x',
+        render: () =>
+          h(Suspense, null, {
+            default: h(createAsync('async', Promise.resolve())),
+            fallback: h('p', 'loading')
+          })
+      }
+      const Comp = {
+        render: () => [
+          h(Suspense, null, {
+            default: h(createAsync('a', Promise.resolve()))
+          }),
+          h(Card)
+        ]
+      }
+      for (let i = 0; i < 2; i++) {
+        const { done, read } = stream(createApp(Comp), { componentCache })
+        await done
+        expect(read()).toMatch(`<template id="vb:1"></template><p>loading</p>`)
+        expect(read()).toMatch(
+          `<template id="vc:1"><div>async</div></template>`
+        )
+      }
+      expect(componentCache.length).toBe(0)
+    })
+  })
 })
@@ -0,0 +1,210 @@
+/**
+ * @jest-environment node
+ */
+
+import { existsSync } from 'fs'
+import { resolve } from 'path'
+import { createApp, h, Teleport, useSSRContext } from 'vue'
+import {
+  createLatencyRecorder,
+  createSSRWorkerPool,
+  postWithContext,
+  renderRequest,
+  serializeContext
+} from '../src/workerPool'
+import { SSRContext } from '../src/render'
+
+// The pool itself needs the Node.js builds to boot its workers
+// (`node scripts/build.js vue server-renderer -f cjs`), so the other tests
+// cover the parts that run on either side of the boundary.
+const rendererPath = resolve(__dirname, '../dist/server-renderer.cjs.js')
+const testWithBuild = existsSync(rendererPath) ? test : test.skip
+
+describe('ssr: worker pool', () => {
+  const decoder = new TextDecoder()
+
+  const factory = (context: SSRContext) =>
+    createApp({
+      setup() {
+        useSSRContext()!.modules.add(`${context.url}.vue`)
+        return () =>
+          h('div', [
+            'hello',
+            h(Teleport, { to: '#modal' }, h('span', context.url))
+          ])
+      }
+    })
+
+  const request = (type: 'string' | 'stream') => {
+    const messages: any[] = []
+    const transfers: ArrayBuffer[][] = []
+    const context = serializeContext({ url: '/foo', modules: new Set() })
+    return renderRequest(
+      factory,
+      { id: 1, type, context },
+      (msg, transfer) => {
+        messages.push(msg)
+        transfers.push(transfer || [])
+      }
+    ).then(() => ({ messages, transfers }))
+  }
+
+  test('renders to a transferable buffer', async () => {
+    const { messages, transfers } = await request('string')
+    expect(messages).toHaveLength(1)
+    const [done] = messages
+    expect(done.type).toBe('done')
+    expect(done.id).toBe(1)
+    expect(done.html).toBeInstanceOf(Uint8Array)
+    expect(transfers[0]).toEqual([done.html.buffer])
+    expect(decoder.decode(done.html)).toBe(
+      `<div>hello<!--teleport start--><!--teleport end--></div>`
+    )
+  })
+
+  test('preserves teleports and modules', async () => {
+    const { messages } = await request('string')
+    const { context } = messages[0]
+    expect(context.teleports).toEqual({
+      '#modal': `<span>/foo</span><!---->`
+    })
+    expect(context.modules).toEqual(new Set(['/foo.vue']))
+    expect(context.url).toBe('/foo')
+  })
+
+  test('streams chunks', async () => {
+    const { messages, transfers } = await request('stream')
+    const chunks = messages.filter(m => m.type === 'chunk')
+    expect(chunks.length).toBeGreaterThan(0)
+    chunks.forEach((m, i) => {
+      expect(m.chunk).toBeInstanceOf(Uint8Array)
+      expect(transfers[i]).toEqual([m.chunk.buffer])
+    })
+    expect(chunks.map(m => decoder.decode(m.chunk)).join('')).toBe(
+      `<div>hello<!--teleport start--><!--teleport end--></div>`
+    )
+    const done = messages[messages.length - 1]
+    expect(done.type).toBe('done')
+    expect(done.html).toBeUndefined()
+    expect(done.context.teleports['#modal']).toBe(
+      `<span>/foo</span><!---->`
+    )
+  })
+
+  test('reports errors', async () => {
+    const messages: any[] = []
+    await renderRequest(
+      () => {
+        throw new Error('boom')
+      },
+      { id: 2, type: 'string', context: {} },
+      msg => messages.push(msg)
+    )
+    expect(messages).toMatchObject([{ id: 2, type: 'error', message: 'boom' }])
+  })
+
+  const createContext = (): SSRContext => ({
+    url: '/',
+    modules: new Set(['a']),
+    __teleportBuffers: {},
+    componentCache: { get() {}, set() {} },
+    store: { state: { count: 1 }, commit() {} },
+    fn() {}
+  })
+
+  test('serializeContext', () => {
+    const context = serializeContext(createContext())
+    expect(Object.keys(context)).toEqual(['url', 'modules', 'store'])
+    expect(
+      `SSR context property "componentCache" cannot be passed`
+    ).toHaveBeenWarned()
+
+    // values are only probed on request
+    expect(Object.keys(serializeContext(createContext(), true))).toEqual([
+      'url',
+      'modules'
+    ])
+    expect(`SSR context property "store" cannot be passed`).toHaveBeenWarned()
+  })
+
+  test('postWithContext', () => {
+    const sent: any[] = []
+    const post = (msg: any) => sent.push(structuredClone(msg))
+
+    postWithContext(post, { id: 1, context: { url: '/' } })
+    expect(sent).toEqual([{ id: 1, context: { url: '/' } }])
+
+    // retried without the values that cannot be cloned
+    postWithContext(post, { id: 2, context: createContext() })
+    expect(sent[1]).toEqual({
+      id: 2,
+      context: { url: '/', modules: new Set(['a']) }
+    })
+    expect(
+      `SSR context property "componentCache" cannot be passed`
+    ).toHaveBeenWarnedTimes(1)
+    expect(`SSR context property "store" cannot be passed`).toHaveBeenWarned()
+  })
+
+  testWithBuild('renders in worker threads', async () => {
+    const pool = createSSRWorkerPool(resolve(__dirname, 'fixture/ssrApp.js'), {
+      threads: 2,
+      rendererPath
+    })
+    try {
+      const context: SSRContext = {
+        url: '/foo',
+        modules: new Set(),
+        componentCache: { get() {}, set() {} }
+      }
+      expect(await pool.renderToString(context)).toBe(
+        `<div>hello<!--teleport start--><!--teleport end--></div>`
+      )
+      expect(context.teleports).toEqual({
+        '#modal': `<span>/foo</span><!---->`
+      })
+      expect(context.modules).toEqual(new Set(['/foo.vue']))
+      expect(
+        `SSR context property "componentCache" cannot be passed`
+      ).toHaveBeenWarned()
+
+      const streamContext: SSRContext = { url: '/bar', modules: new Set() }
+      let html = ''
+      for await (const chunk of pool.renderToNodeStream(streamContext)) {
+        html += chunk
+      }
+      expect(html).toBe(
+        `<div>hello<!--teleport start--><!--teleport end--></div>`
+      )
+      expect(streamContext.teleports!['#modal']).toBe(
+        `<span>/bar</span><!---->`
+      )
+
+      const stats = pool.stats()
+      expect(stats).toHaveLength(2)
+      expect(stats.reduce((n, s) => n + s.completed, 0)).toBe(2)
+    } finally {
+      await pool.close()
+    }
+  })
+
+  test('latency histogram', () => {
+    const recorder = createLatencyRecorder()
+    expect(recorder.snapshot()).toMatchObject({ count: 0, min: 0, p50: 0 })
+    for (let i = 0; i < 90; i++) recorder.record(0.5)
+    for (let i = 0; i < 9; i++) recorder.record(30)
+    recorder.record(8000)
+    const stats = recorder.snapshot()
+    expect(stats.count).toBe(100)
+    expect(stats.counts[0]).toBe(90)
+    expect(stats.counts[stats.bounds.indexOf(50)]).toBe(9)
+    expect(stats.counts[stats.counts.length - 1]).toBe(1)
+    expect(stats.min).toBe(0.5)
+    expect(stats.max).toBe(8000)
+    // upper bound of the bucket
+    expect(stats.p50).toBe(1)
+    expect(stats.p90).toBe(1)
+    expect(stats.p99).toBe(50)
+    expect(stats.sum).toBe(45 + 270 + 8000)
+  })
+})
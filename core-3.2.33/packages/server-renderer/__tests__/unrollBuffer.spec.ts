@@ -0,0 +1,97 @@
+/**
+ * @jest-environment node
+ */
+
+import { createApp, h } from 'vue'
+import { SSRBuffer } from '../src/render'
+import { renderToSimpleStream } from '../src/renderToStream'
+import {
+  createChunkWriter,
+  unrollBuffer,
+  unrollBufferToString
+} from '../src/unrollBuffer'
+
+function collect(highWaterMark: number) {
+  const chunks: string[] = []
+  const writer = createChunkWriter(chunk => chunks.push(chunk), highWaterMark)
+  return { chunks, writer }
+}
+
+describe('ssr: unrollBuffer', () => {
+  test('sync and async buffers', async () => {
+    const buffer: SSRBuffer = [
+      'a',
+      ['b', ['c'], Promise.resolve(['d', Promise.resolve(['e'])] as SSRBuffer)],
+      'f'
+    ]
+    expect(await unrollBufferToString(buffer)).toBe('abcdef')
+  })
+
+  test('deeply nested buffers', async () => {
+    const depth = 100000
+    let buffer: SSRBuffer = ['x']
+    for (let i = 0; i < depth; i++) {
+      buffer = ['<', buffer, '>']
+    }
+    expect(await unrollBufferToString(buffer)).toBe(
+      '<'.repeat(depth) + 'x' + '>'.repeat(depth)
+    )
+  })
+
+  test('coalesces chunks up to the high water mark', async () => {
+    const { chunks, writer } = collect(4)
+    await unrollBuffer(['ab', ['c', 'd'], 'efgh', 'i'], writer)
+    writer.end()
+    expect(chunks).toEqual(['abcd', 'efgh', 'i'])
+  })
+
+  test('pushes every chunk with a high water mark of 0', async () => {
+    const { chunks, writer } = collect(0)
+    await unrollBuffer(['ab', ['c', ''], 'd'], writer)
+    writer.end()
+    expect(chunks).toEqual(['ab', 'c', 'd'])
+  })
+
+  test('flushes pending output before waiting on async items', async () => {
+    const { chunks, writer } = collect(1024)
+    let resolve!: (buffer: SSRBuffer) => void
+    const done = unrollBuffer(
+      ['a', new Promise<SSRBuffer>(r => (resolve = r)), 'c'],
+      writer
+    )
+    await Promise.resolve()
+    expect(chunks).toEqual(['a'])
+    resolve(['b'])
+    await done
+    writer.end()
+    expect(chunks).toEqual(['a', 'bc'])
+  })
+
+  test('renderToSimpleStream highWaterMark option', async () => {
+    const render = (highWaterMark?: number) =>
+      new Promise<string[]>((resolve, reject) => {
+        const chunks: string[] = []
+        const Item = { render: () => h('li') }
+        const app = createApp({
+          render: () => h('ul', [h(Item), h(Item), h(Item)])
+        })
+        renderToSimpleStream(
+          app,
+          {},
+          {
+            push(chunk) {
+              chunk == null ? resolve(chunks) : chunks.push(chunk)
+            },
+            destroy: reject
+          },
+          highWaterMark == null ? undefined : { highWaterMark }
+        )
+      })
+
+    const html = `<ul><li></li><li></li><li></li></ul>`
+    expect(await render()).toEqual([html])
+    const chunks = await render(0)
+    expect(chunks.length).toBeGreaterThan(1)
+    expect(chunks.join('')).toBe(html)
+  })
+})
@@ -0,0 +1,24 @@
+import { createLRUCache, LRUCache, LRUCacheOptions, utf8Length } from './lru'
+
+/**
+ * Store used for components with a `serverCacheKey` option. Any object
+ * implementing this interface can be passed as `componentCache` in the
+ * SSR context; `createSSRComponentCache()` provides a bounded LRU.
+ */
+export interface SSRComponentCache {
+  get(key: string): string | undefined
+  set(key: string, html: string): void
+}
+
+/**
+ * `maxSize` is the total size of the cached HTML in UTF-8 bytes.
+ */
+export type SSRComponentCacheOptions = LRUCacheOptions
+
+export type SSRComponentLRUCache = LRUCache<string>
+
+export function createSSRComponentCache(
+  options: SSRComponentCacheOptions = {}
+): SSRComponentLRUCache {
+  return createLRUCache(options, utf8Length)
+}
@@ -1,8 +1,20 @@
-import { ComponentInternalInstance, ComponentOptions, warn } from 'vue'
+import {
+  AppConfig,
+  ComponentInternalInstance,
+  ComponentOptions,
+  warn
+} from 'vue'
 import { compile } from '@vue/compiler-ssr'
-import { extend, generateCodeFrame, isFunction, NO } from '@vue/shared'
+import {
+  extend,
+  generateCodeFrame,
+  isFunction,
+  isObject,
+  NO
+} from '@vue/shared'
 import { CompilerError, CompilerOptions } from '@vue/compiler-core'
 import { PushFn } from '../render'
+import { createLRUCache, LRUCache, utf8Length } from '../lru'
 
 type SSRRenderFunction = (
   context: any,
@@ -10,7 +22,223 @@ type SSRRenderFunction = (
   parentInstance: ComponentInternalInstance
 ) => void
 
-const compileCache: Record<string, SSRRenderFunction> = Object.create(null)
+interface CompileCacheEntry {
+  template: string
+  code: string
+  render: SSRRenderFunction
+  scope: CompileScope
+}
+
+// compiled templates for one set of compiler options
+interface CompileScope {
+  isCustomElement: AppConfig['isCustomElement']
+  appOptions: CompilerOptions
+  delimiters: ComponentOptions['delimiters']
+  componentOptions: CompilerOptions | undefined
+  options: CompilerOptions
+  // serialized options, only computed for the disk cache
+  key: string | null
+  templates: Map<string, CompileCacheEntry>
+}
+
+export interface SSRCompileCacheOptions {
+  /**
+   * Maximum number of compiled templates kept in memory.
+   * @default 1000
+   */
+  max?: number
+  /**
+   * Maximum total size of the cached templates and generated code, in UTF-8
+   * bytes.
+   * @default 32MB
+   */
+  maxSize?: number
+  /**
+   * When set, generated code is also written to this directory and read back
+   * on in-memory misses, so that new processes can skip compilation.
+   * Node.js build only.
+   */
+  cacheDir?: string | null
+}
+
+export interface SSRCompileCacheStats {
+  hits: number
+  misses: number
+  evictions: number
+  /**
+   * Number of in-memory misses served from `cacheDir`
+   */
+  diskHits: number
+  compiles: number
+  /**
+   * Total time spent compiling, in milliseconds
+   */
+  compileTime: number
+  length: number
+  size: number
+}
+
+let compileCache: LRUCache<CompileCacheEntry, CompileCacheEntry>
+let compileScopes: CompileScope[]
+let configScopes: WeakMap<AppConfig, CompileScope>
+let cacheDir: string | null = null
+let hits = 0
+let misses = 0
+let diskHits = 0
+let compiles = 0
+let compileTime = 0
+
+configureSSRCompileCache()
+
+/**
+ * Replaces the cache used for on-the-fly compiled templates. Existing entries
+ * and statistics are discarded.
+ */
+export function configureSSRCompileCache(options: SSRCompileCacheOptions = {}) {
+  const { max = 1000, maxSize = 32 * 1024 * 1024 } = options
+  compileCache = createLRUCache<CompileCacheEntry, CompileCacheEntry>(
+    { max, maxSize },
+    entry => utf8Length(entry.template) + utf8Length(entry.code),
+    entry => entry.scope.templates.delete(entry.template)
+  )
+  compileScopes = []
+  configScopes = new WeakMap()
+  cacheDir = null
+  hits = misses = diskHits = compiles = compileTime = 0
+  if (options.cacheDir) {
+    if (__NODE_JS__) {
+      cacheDir = options.cacheDir
+      require('fs').mkdirSync(cacheDir, { recursive: true })
+    } else if (__DEV__) {
+      warn(
+        `[@vue/server-renderer] The compile cacheDir option is only ` +
+          `supported in the Node.js build and is ignored.`
+      )
+    }
+  }
+}
+
+export function getSSRCompileCacheStats(): SSRCompileCacheStats {
+  const { evictions, length, size } = compileCache
+  return {
+    hits,
+    misses,
+    evictions,
+    diskHits,
+    compiles,
+    compileTime,
+    length,
+    size
+  }
+}
+
+// compares options like their serialized form does, i.e. functions by source
+function isSameOption(a: any, b: any): boolean {
+  if (a === b) {
+    return true
+  }
+  if (isFunction(a) && isFunction(b)) {
+    return a.toString() === b.toString()
+  }
+  if (!isObject(a) || !isObject(b)) {
+    return false
+  }
+  const keys = Object.keys(a)
+  if (keys.length !== Object.keys(b).length) {
+    return false
+  }
+  for (let i = 0; i < keys.length; i++) {
+    const key = keys[i]
+    if (!isSameOption((a as any)[key], (b as any)[key])) {
+      return false
+    }
+  }
+  return true
+}
+
+// Apps are usually created per request and only call this once per
+// component, so the scope of an app is remembered and new apps look up an
+// existing scope by value.
+function getCompileScope(
+  Component: ComponentOptions,
+  config: AppConfig
+): CompileScope {
+  const { delimiters, compilerOptions: componentOptions } = Component
+  const hasOwnOptions = !!(delimiters || componentOptions)
+  if (!hasOwnOptions) {
+    const scope = configScopes.get(config)
+    if (scope) {
+      return scope
+    }
+  }
+
+  const { isCustomElement, compilerOptions: appOptions } = config
+  let scope: CompileScope | undefined
+  for (let i = 0; i < compileScopes.length; i++) {
+    const s = compileScopes[i]
+    if (
+      isSameOption(s.isCustomElement, isCustomElement) &&
+      isSameOption(s.appOptions, appOptions) &&
+      isSameOption(s.delimiters, delimiters) &&
+      isSameOption(s.componentOptions, componentOptions)
+    ) {
+      scope = s
+      break
+    }
+  }
+
+  if (!scope) {
+    // TODO: This is copied from runtime-core/src/component.ts and should probably be refactored
+    const options: CompilerOptions = extend(
+      extend(
+        {
+          isCustomElement,
+          delimiters
+        },
+        appOptions
+      ),
+      componentOptions
+    )
+    options.isCustomElement = options.isCustomElement || NO
+    options.isNativeTag = options.isNativeTag || NO
+    compileScopes.push(
+      (scope = {
+        isCustomElement,
+        appOptions: extend({}, appOptions),
+        delimiters,
+        componentOptions: componentOptions && extend({}, componentOptions),
+        options,
+        key: null,
+        templates: new Map()
+      })
+    )
+  }
+  if (!hasOwnOptions) {
+    configScopes.set(config, scope)
+  }
+  return scope
+}
+
+function readCachedCode(file: string): string | null {
+  try {
+    return require('fs').readFileSync(file, 'utf-8')
+  } catch (e) {
+    return null
+  }
+}
+
+function writeCachedCode(file: string, code: string) {
+  const fs = require('fs')
+  // write to a temporary file first so that concurrent workers never read
+  // partially written code
+  const tmp = `${file}.${process.pid}.${Date.now()}.tmp`
+  fs.writeFile(tmp, code, (err: Error | null) => {
+    if (err) return
+    fs.rename(tmp, file, (err: Error | null) => {
+      if (err) fs.unlink(tmp, () => {})
+    })
+  })
+}
 
 export function ssrCompile(
   template: string,
@@ -24,42 +252,45 @@ export function ssrCompile(
     )
   }
 
-  // TODO: This is copied from runtime-core/src/component.ts and should probably be refactored
-  const Component = instance.type as ComponentOptions
-  const { isCustomElement, compilerOptions } = instance.appContext.config
-  const { delimiters, compilerOptions: componentCompilerOptions } = Component
-
-  const finalCompilerOptions: CompilerOptions = extend(
-    extend(
-      {
-        isCustomElement,
-        delimiters
-      },
-      compilerOptions
-    ),
-    componentCompilerOptions
+  const scope = getCompileScope(
+    instance.type as ComponentOptions,
+    instance.appContext.config
   )
+  const cached = scope.templates.get(template)
+  if (cached) {
+    hits++
+    // mark as recently used
+    compileCache.get(cached)
+    return cached.render
+  }
+  misses++
 
-  finalCompilerOptions.isCustomElement =
-    finalCompilerOptions.isCustomElement || NO
-  finalCompilerOptions.isNativeTag = finalCompilerOptions.isNativeTag || NO
-
-  const cacheKey = JSON.stringify(
-    {
-      template,
-      compilerOptions: finalCompilerOptions
-    },
-    (key, value) => {
-      return isFunction(value) ? value.toString() : value
+  let cacheFile: string | undefined
+  if (__NODE_JS__ && cacheDir) {
+    if (scope.key === null) {
+      scope.key = JSON.stringify(scope.options, (key, value) => {
+        return isFunction(value) ? value.toString() : value
+      })
+    }
+    const hash = require('crypto')
+      .createHash('sha256')
+      .update(scope.key)
+      .update('\0')
+      .update(template)
+      .digest('hex')
+    cacheFile = require('path').join(cacheDir, `${hash}.js`)
+    const code = readCachedCode(cacheFile!)
+    if (code != null) {
+      diskHits++
+      return cacheCompiled(scope, template, code)
     }
-  )
-
-  const cached = compileCache[cacheKey]
-  if (cached) {
-    return cached
   }
 
+  // the shared options object is left untouched
+  const finalCompilerOptions = extend({}, scope.options)
+  let hasError = false
   finalCompilerOptions.onError = (err: CompilerError) => {
+    hasError = true
     if (__DEV__) {
       const message = `[@vue/server-renderer] Template compilation error: ${err.message}`
       const codeFrame =
@@ -75,6 +306,27 @@ export function ssrCompile(
     }
   }
 
+  const start = process.hrtime()
   const { code } = compile(template, finalCompilerOptions)
-  return (compileCache[cacheKey] = Function('require', code)(require))
+  const [s, ns] = process.hrtime(start)
+  compileTime += s * 1e3 + ns / 1e6
+  compiles++
+
+  if (__NODE_JS__ && cacheFile && !hasError) {
+    writeCachedCode(cacheFile, code)
+  }
+  return cacheCompiled(scope, template, code)
+}
+
+function cacheCompiled(
+  scope: CompileScope,
+  template: string,
+  code: string
+): SSRRenderFunction {
+  const render = Function('require', code)(require)
+  const entry: CompileCacheEntry = { template, code, render, scope }
+  if (compileCache.set(entry, entry)) {
+    scope.templates.set(template, entry)
+  }
+  return render
 }
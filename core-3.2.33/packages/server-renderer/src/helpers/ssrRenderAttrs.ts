@@ -1,5 +1,7 @@
+import { mergeProps } from 'vue'
 import { escapeHtml, stringifyStyle } from '@vue/shared'
 import {
+  hasOwn,
   normalizeClass,
   normalizeStyle,
   propsToAttrMap,
@@ -39,6 +41,24 @@ export function ssrRenderAttrs(
   return ret
 }
 
+// Render the attrs of an element whose leading static attrs were serialized
+// at compile time. Only the dynamic props are walked, unless they override a
+// static attr - then the props are merged like they would have been without
+// the compile-time serialization.
+export function ssrRenderDynamicAttrs(
+  props: Record<string, unknown>,
+  staticProps: Record<string, unknown>,
+  staticAttrs: string,
+  tag?: string
+): string {
+  for (const key in props) {
+    if (hasOwn(staticProps, key)) {
+      return ssrRenderAttrs(mergeProps(staticProps, props), tag)
+    }
+  }
+  return staticAttrs + ssrRenderAttrs(props, tag)
+}
+
 // render an attr with dynamic (unknown) key.
 export function ssrRenderDynamicAttr(
   key: string,
@@ -1,12 +1,72 @@
-import { PushFn } from '../render'
+import { ComponentInternalInstance, ssrContextKey } from 'vue'
+import { createBuffer, PushFn, SSRContext } from '../render'
+
+type SuspenseSlot = (push: PushFn) => void
 
 export async function ssrRenderSuspense(
   push: PushFn,
-  { default: renderContent }: Record<string, (() => void) | undefined>
+  {
+    default: renderContent,
+    fallback: renderFallback
+  }: Record<string, SuspenseSlot | undefined>,
+  parentComponent?: ComponentInternalInstance
 ) {
   if (renderContent) {
-    renderContent()
+    // slots compiled before out-of-order streaming was supported push into
+    // the outer buffer directly, so they can only be rendered in order
+    if (parentComponent && renderContent.length) {
+      renderSuspenseBoundary(
+        push,
+        parentComponent,
+        renderContent,
+        renderFallback
+      )
+    } else {
+      renderContent(push)
+    }
   } else {
     push(`<!---->`)
   }
 }
+
+/**
+ * When streaming out of order, a boundary whose content does not resolve
+ * synchronously is rendered as
+ *
+ *   <!--$?--><template id="vb:{id}"></template>{fallback}<!--/$-->
+ *
+ * and its content buffer is queued on the context, to be streamed after the
+ * rest of the document together with a script that swaps it in (see
+ * `renderToStream.ts`). After the swap the boundary is left as
+ * `<!--$-->{content}<!--/$-->`, which hydration knows to unwrap.
+ */
+export function renderSuspenseBoundary(
+  push: PushFn,
+  parentComponent: ComponentInternalInstance,
+  renderContent: SuspenseSlot,
+  renderFallback?: SuspenseSlot
+) {
+  const context = parentComponent.appContext.provides[
+    ssrContextKey as any
+  ] as SSRContext | undefined
+  const boundaries = context && context.__suspenseBoundaries
+  if (!boundaries) {
+    renderContent(push)
+    return
+  }
+
+  const { getBuffer, push: pushContent } = createBuffer()
+  renderContent(pushContent)
+  const content = getBuffer()
+  if (!content.hasAsync) {
+    push(content)
+    return
+  }
+
+  const id = boundaries.push(content) - 1
+  push(`<!--$?--><template id="vb:${id}"></template>`)
+  if (renderFallback) {
+    renderFallback(push)
+  }
+  push(`<!--/$-->`)
+}
@@ -25,6 +25,7 @@ export function ssrRenderTeleport(
   const context = parentComponent.appContext.provides[
     ssrContextKey as any
   ] as SSRContext
+  context.__teleportCount = (context.__teleportCount || 0) + 1
   const teleportBuffers =
     context.__teleportBuffers || (context.__teleportBuffers = {})
   if (teleportBuffers[target]) {
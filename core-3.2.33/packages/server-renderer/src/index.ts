@@ -3,6 +3,18 @@ initDirectivesForSSR()
 
 // public
 export { SSRContext } from './render'
+export {
+  createSSRComponentCache,
+  SSRComponentCache,
+  SSRComponentCacheOptions,
+  SSRComponentLRUCache
+} from './componentCache'
+export {
+  configureSSRCompileCache,
+  getSSRCompileCacheStats,
+  SSRCompileCacheOptions,
+  SSRCompileCacheStats
+} from './helpers/ssrCompile'
 export { renderToString } from './renderToString'
 export {
   renderToSimpleStream,
@@ -11,9 +23,17 @@ export {
   renderToWebStream,
   pipeToWebWritable,
   SimpleReadable,
+  SSRStreamOptions,
   // deprecated
   renderToStream
 } from './renderToStream'
+export {
+  createSSRWorkerPool,
+  SSRWorkerPool,
+  SSRWorkerPoolOptions,
+  SSRWorkerStats,
+  SSRLatencyHistogram
+} from './workerPool'
 
 // internal runtime helpers
 export { renderVNode as ssrRenderVNode } from './render'
@@ -24,6 +44,7 @@ export {
   ssrRenderClass,
   ssrRenderStyle,
   ssrRenderAttrs,
+  ssrRenderDynamicAttrs,
   ssrRenderAttr,
   ssrRenderDynamicAttr
 } from './helpers/ssrRenderAttrs'
@@ -32,6 +53,7 @@ export { ssrRenderList } from './helpers/ssrRenderList'
 export { ssrRenderSuspense } from './helpers/ssrRenderSuspense'
 export { ssrGetDirectiveProps } from './helpers/ssrGetDirectiveProps'
 export { includeBooleanAttr as ssrIncludeBooleanAttr } from '@vue/shared'
+export { ssrRunWorker } from './workerPool'
 
 // v-model helpers
 export {
@@ -0,0 +1,126 @@
+export interface LRUCacheOptions {
+  /**
+   * Maximum number of entries.
+   * @default Infinity
+   */
+  max?: number
+  /**
+   * Maximum total size of all entries, as measured by `sizeOf`.
+   * @default Infinity
+   */
+  maxSize?: number
+}
+
+export interface LRUCache<V, K = string> {
+  readonly hits: number
+  readonly misses: number
+  readonly evictions: number
+  /**
+   * Number of cached entries
+   */
+  readonly length: number
+  /**
+   * Total size of the cached entries
+   */
+  readonly size: number
+  get(key: K): V | undefined
+  /**
+   * Returns false if the value is larger than `maxSize` and was not stored
+   */
+  set(key: K, value: V): boolean
+  delete(key: K): boolean
+  clear(): void
+}
+
+export function createLRUCache<V, K = string>(
+  options: LRUCacheOptions,
+  sizeOf: (value: V) => number,
+  onEvict?: (key: K, value: V) => void
+): LRUCache<V, K> {
+  const { max = Infinity, maxSize = Infinity } = options
+  // Map iterates in insertion order, so re-inserting on access keeps the
+  // least recently used entry first.
+  const entries = new Map<K, V>()
+  const sizes = new Map<K, number>()
+  let size = 0
+  let hits = 0
+  let misses = 0
+  let evictions = 0
+
+  function remove(key: K) {
+    size -= sizes.get(key)!
+    sizes.delete(key)
+    return entries.delete(key)
+  }
+
+  return {
+    get hits() {
+      return hits
+    },
+    get misses() {
+      return misses
+    },
+    get evictions() {
+      return evictions
+    },
+    get length() {
+      return entries.size
+    },
+    get size() {
+      return size
+    },
+    get(key) {
+      const value = entries.get(key)
+      if (value === undefined) {
+        misses++
+        return
+      }
+      hits++
+      entries.delete(key)
+      entries.set(key, value)
+      return value
+    },
+    set(key, value) {
+      const valueSize = sizeOf(value)
+      if (entries.has(key)) {
+        remove(key)
+      }
+      if (valueSize > maxSize) {
+        return false
+      }
+      entries.set(key, value)
+      sizes.set(key, valueSize)
+      size += valueSize
+      while (entries.size > max || size > maxSize) {
+        const oldest = entries.keys().next().value!
+        const oldValue = entries.get(oldest)!
+        remove(oldest)
+        evictions++
+        if (onEvict) {
+          onEvict(oldest, oldValue)
+        }
+      }
+      return true
+    },
+    delete(key) {
+      return entries.has(key) && remove(key)
+    },
+    clear() {
+      entries.clear()
+      sizes.clear()
+      size = 0
+    }
+  }
+}
+
+export function utf8Length(str: string): number {
+  let len = str.length
+  for (let i = 0; i < str.length; i++) {
+    const code = str.charCodeAt(i)
+    if (code > 0x7f) {
+      // surrogate pairs are 4 bytes in total, i.e. 2 extra per half
+      len += code > 0x7ff && (code < 0xd800 || code > 0xdfff) ? 2 : 1
+    }
+  }
+  return len
+}
@@ -2,10 +2,13 @@ import {
   Comment,
   Component,
   ComponentInternalInstance,
+  ComponentOptions,
+  AppContext,
   DirectiveBinding,
   Fragment,
   mergeProps,
   ssrUtils,
+  ssrContextKey,
   Static,
   Text,
   VNode,
@@ -27,6 +30,9 @@ import {
 import { ssrRenderAttrs } from './helpers/ssrRenderAttrs'
 import { ssrCompile } from './helpers/ssrCompile'
 import { ssrRenderTeleport } from './helpers/ssrRenderTeleport'
+import { renderSuspenseBoundary } from './helpers/ssrRenderSuspense'
+import { SSRComponentCache } from './componentCache'
+import { unrollBufferSync, unrollBufferToString } from './unrollBuffer'
 
 const {
   createComponentInstance,
@@ -44,7 +50,25 @@ export type Props = Record<string, unknown>
 export type SSRContext = {
   [key: string]: any
   teleports?: Record<string, string>
+  /**
+   * Store for the rendered HTML of components with a `serverCacheKey`
+   * option. Usually shared across requests. Only the HTML is stored: the
+   * `modules` a cached component registers are not collected on cache hits,
+   * and components that render teleports or Suspense boundaries streamed
+   * out of order are not cached.
+   */
+  componentCache?: SSRComponentCache
+  /**
+   * Maximum number of serverPrefetch hooks running at the same time while
+   * rendering this request. Unlimited by default.
+   */
+  maxConcurrentPrefetches?: number
+  __prefetchLimiter?: PrefetchLimiter
   __teleportBuffers?: Record<string, SSRBuffer>
+  // number of teleports rendered so far, see countDetachedContent
+  __teleportCount?: number
+  // content of pending Suspense boundaries when streaming out of order
+  __suspenseBoundaries?: SSRBuffer[]
 }
 
 // Each component has a buffer array.
@@ -82,6 +106,165 @@ export function renderComponentVNode(
   vnode: VNode,
   parentComponent: ComponentInternalInstance | null = null,
   slotScopeId?: string
+): SSRBuffer | Promise<SSRBuffer> {
+  if ((vnode.type as ComponentOptions).serverCacheKey) {
+    const cache = resolveComponentCache(vnode, parentComponent, slotScopeId)
+    if (cache) {
+      const [context, key] = cache
+      const html = context.componentCache!.get(key)
+      if (html !== undefined) {
+        // cache hit: skip setup and render entirely
+        return [html]
+      }
+      const detached = countDetachedContent(context)
+      const res = renderComponentVNodeUncached(
+        vnode,
+        parentComponent,
+        slotScopeId
+      )
+      return isPromise(res)
+        ? res.then(buffer => cacheBuffer(context, key, buffer, detached))
+        : cacheBuffer(context, key, res, detached)
+    }
+  }
+  return renderComponentVNodeUncached(vnode, parentComponent, slotScopeId)
+}
+
+function resolveComponentCache(
+  vnode: VNode,
+  parentComponent: ComponentInternalInstance | null,
+  slotScopeId: string | undefined
+): [SSRContext, string] | null {
+  const appContext = parentComponent
+    ? parentComponent.appContext
+    : vnode.appContext
+  const context = appContext && getSSRContext(appContext)
+  if (!context || !context.componentCache) {
+    return null
+  }
+  const comp = vnode.type as ComponentOptions
+  const key = comp.serverCacheKey!(vnode.props || {})
+  if (key == null || key === false) {
+    return null
+  }
+  if (!comp.name) {
+    if (__DEV__) {
+      warn(
+        `[@vue/server-renderer] Components with serverCacheKey must also ` +
+          `have a unique name option to be cached.`
+      )
+    }
+    return null
+  }
+  // inherited and slot scope ids end up in the rendered root element
+  let scopeIds = getInheritedScopeIds(vnode, parentComponent)
+  if (slotScopeId) {
+    scopeIds += ` ${slotScopeId.trim()}`
+  }
+  return [
+    context,
+    `${comp.name}::${key}` + (scopeIds ? `::${scopeIds.trim()}` : ``)
+  ]
+}
+
+// scope ids of the vnode and of the parents it is the root of, the same
+// ones renderComponentSubTree() and renderElementVNode() add to the root
+function getInheritedScopeIds(
+  vnode: VNode,
+  parentComponent: ComponentInternalInstance | null
+): string {
+  let ids = vnode.scopeId || ``
+  let cur = vnode
+  while (parentComponent && parentComponent.subTree === cur) {
+    cur = parentComponent.vnode
+    if (cur.scopeId) {
+      ids += ` ${cur.scopeId}`
+    }
+    parentComponent = parentComponent.parent
+  }
+  return ids
+}
+
+// Teleported content and the content of Suspense boundaries streamed out of
+// order are not part of the component's HTML, which only holds placeholders
+// for them, so components that render either are not cached.
+function countDetachedContent(context: SSRContext): number {
+  const boundaries = context.__suspenseBoundaries
+  return (context.__teleportCount || 0) + (boundaries ? boundaries.length : 0)
+}
+
+// async subtrees may be rendered alongside other components, which makes the
+// check conservative for them
+function cacheBuffer(
+  context: SSRContext,
+  key: string,
+  buffer: SSRBuffer,
+  detached: number
+): SSRBuffer | Promise<SSRBuffer> {
+  const store = (html: string): SSRBuffer => {
+    if (countDetachedContent(context) === detached) {
+      context.componentCache!.set(key, html)
+    }
+    return [html]
+  }
+  return buffer.hasAsync
+    ? unrollBufferToString(buffer).then(store)
+    : store(unrollBufferSync(buffer))
+}
+
+function getSSRContext(appContext: AppContext): SSRContext | undefined {
+  return appContext.provides[ssrContextKey as any]
+}
+
+type PrefetchLimiter = (task: () => unknown) => Promise<unknown>
+
+function createPrefetchLimiter(max: number): PrefetchLimiter {
+  let active = 0
+  const queue: (() => void)[] = []
+  const release = () => {
+    active--
+    if (queue.length) queue.shift()!()
+  }
+  return task =>
+    new Promise((resolve, reject) => {
+      const run = () => {
+        active++
+        const res = Promise.resolve().then(task)
+        res.then(release, release)
+        res.then(resolve, reject)
+      }
+      if (active < max) {
+        run()
+      } else {
+        queue.push(run)
+      }
+    })
+}
+
+function runPrefetches(instance: ComponentInternalInstance) {
+  const prefetches = instance.sp! /* LifecycleHooks.SERVER_PREFETCH */
+  const context = getSSRContext(instance.appContext)
+  let limit: PrefetchLimiter | undefined
+  if (context && context.maxConcurrentPrefetches) {
+    limit =
+      context.__prefetchLimiter ||
+      (context.__prefetchLimiter = createPrefetchLimiter(
+        context.maxConcurrentPrefetches
+      ))
+  }
+  return Promise.all(
+    prefetches.map(prefetch =>
+      limit
+        ? limit(() => prefetch.call(instance.proxy))
+        : prefetch.call(instance.proxy)
+    )
+  )
+}
+
+function renderComponentVNodeUncached(
+  vnode: VNode,
+  parentComponent: ComponentInternalInstance | null,
+  slotScopeId?: string
 ): SSRBuffer | Promise<SSRBuffer> {
   const instance = createComponentInstance(vnode, parentComponent, null)
   const res = setupComponent(instance, true /* isSSR */)
@@ -93,9 +276,7 @@ export function renderComponentVNode(
       : Promise.resolve()
     if (prefetches) {
       p = p
-        .then(() =>
-          Promise.all(prefetches.map(prefetch => prefetch.call(instance.proxy)))
-        )
+        .then(() => runPrefetches(instance))
         // Note: error display is already done by the wrapped lifecycle hook function.
         .catch(() => {})
     }
@@ -240,7 +421,14 @@ export function renderVNode(
       } else if (shapeFlag & ShapeFlags.TELEPORT) {
         renderTeleportVNode(push, vnode, parentComponent, slotScopeId)
       } else if (shapeFlag & ShapeFlags.SUSPENSE) {
-        renderVNode(push, vnode.ssContent!, parentComponent, slotScopeId)
+        renderSuspenseBoundary(
+          push,
+          parentComponent,
+          push =>
+            renderVNode(push, vnode.ssContent!, parentComponent, slotScopeId),
+          push =>
+            renderVNode(push, vnode.ssFallback!, parentComponent, slotScopeId)
+        )
       } else {
         warn(
           '[@vue/server-renderer] Invalid VNode type:',
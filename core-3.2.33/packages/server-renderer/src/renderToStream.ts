@@ -6,8 +6,14 @@ import {
   createApp,
   ssrContextKey
 } from 'vue'
-import { isString, isPromise } from '@vue/shared'
+import { escapeHtml, isPromise } from '@vue/shared'
 import { renderComponentVNode, SSRBuffer, SSRContext } from './render'
+import {
+  createChunkWriter,
+  SSRWriter,
+  unrollBuffer,
+  unrollBufferToString
+} from './unrollBuffer'
 import { Readable, Writable } from 'stream'
 
 const { isVNode } = ssrUtils
@@ -17,52 +23,101 @@ export interface SimpleReadable {
   destroy(err: any): void
 }
 
-async function unrollBuffer(
-  buffer: SSRBuffer,
-  stream: SimpleReadable
-): Promise<void> {
-  if (buffer.hasAsync) {
-    for (let i = 0; i < buffer.length; i++) {
-      let item = buffer[i]
-      if (isPromise(item)) {
-        item = await item
-      }
-      if (isString(item)) {
-        stream.push(item)
-      } else {
-        await unrollBuffer(item, stream)
-      }
-    }
-  } else {
-    // sync buffer can be more efficiently unrolled without unnecessary await
-    // ticks
-    unrollBufferSync(buffer, stream)
-  }
+export interface SSRStreamOptions {
+  /**
+   * Rendered output is coalesced into chunks of at least this many characters
+   * before it is pushed to the stream. Pending output is always pushed before
+   * waiting on an async component. Set to 0 to push every piece as soon as it
+   * is rendered.
+   * @default 16384
+   */
+  highWaterMark?: number
+  /**
+   * Do not let pending Suspense boundaries hold back the rest of the page.
+   * Their fallback is streamed in place, and their content is streamed after
+   * the document as soon as it resolves, along with an inline script that
+   * swaps it in.
+   */
+  outOfOrder?: boolean
+  /**
+   * Nonce added to the inline scripts of out-of-order streaming, for pages
+   * served with a Content Security Policy.
+   */
+  nonce?: string
 }
 
-function unrollBufferSync(buffer: SSRBuffer, stream: SimpleReadable) {
-  for (let i = 0; i < buffer.length; i++) {
-    let item = buffer[i]
-    if (isString(item)) {
-      stream.push(item)
-    } else {
-      // since this is a sync buffer, child buffers are never promises
-      unrollBufferSync(item as SSRBuffer, stream)
+const DEFAULT_HIGH_WATER_MARK = 16 * 1024
+
+// Swaps a resolved boundary (<template id="vc:{id}">) in place of its
+// placeholder (<template id="vb:{id}">) and fallback, see
+// helpers/ssrRenderSuspense.ts. Boundaries nested in content that has not
+// been swapped in yet are retried after each successful swap.
+const SWAP_SCRIPT =
+  `function $vs(i){var q=$vs.q=$vs.q||[],n=0,t,c,s,p,e,x,d;q.push(i);` +
+  `while(n<q.length){t=document.getElementById("vb:"+q[n]);` +
+  `c=document.getElementById("vc:"+q[n]);if(!t||!c){n++;continue}` +
+  `q.splice(n,1);n=0;s=t.previousSibling;p=t.parentNode;e=t.nextSibling;` +
+  `d=0;while(e){if(e.nodeType===8){if(e.data==="/$"){if(!d)break;d--}` +
+  `else if(e.data[0]==="$")d++}x=e.nextSibling;p.removeChild(e);e=x}` +
+  `p.insertBefore(c.content,e);p.removeChild(t);c.parentNode.removeChild(c);` +
+  `s.data="$"}}`
+
+async function renderSuspenseBoundaries(
+  boundaries: SSRBuffer[],
+  writer: SSRWriter,
+  nonce: string | undefined
+) {
+  const scriptTag = nonce
+    ? `<script nonce="${escapeHtml(nonce)}">`
+    : `<script>`
+  // removed once written, not when settled: boundaries resolving in the same
+  // tick would be dropped otherwise
+  const pending = new Map<number, Promise<[number, string]>>()
+  let queued = 0
+  // boundaries register nested boundaries while their content renders, so
+  // pick up new ones after each one completes
+  const queue = () => {
+    for (; queued < boundaries.length; queued++) {
+      const id = queued
+      pending.set(
+        id,
+        unrollBufferToString(boundaries[id]).then(
+          html => [id, html] as [number, string]
+        )
+      )
     }
   }
+
+  queue()
+  // send the document with all fallbacks before waiting on any boundary
+  writer.flush()
+  let hasScript = false
+  while (pending.size) {
+    const [id, html] = await Promise.race(pending.values())
+    pending.delete(id)
+    writer.write(
+      `<template id="vc:${id}">${html}</template>` +
+        `${scriptTag}${hasScript ? `` : SWAP_SCRIPT}$vs(${id})</script>`
+    )
+    writer.flush()
+    hasScript = true
+    queue()
+  }
 }
 
 export function renderToSimpleStream<T extends SimpleReadable>(
   input: App | VNode,
   context: SSRContext,
-  stream: T
+  stream: T,
+  options: SSRStreamOptions = {}
 ): T {
   if (isVNode(input)) {
     // raw vnode, wrap with app (for context)
     return renderToSimpleStream(
       createApp({ render: () => input }),
       context,
-      stream
+      stream,
+      options
     )
   }
 
@@ -72,9 +127,26 @@ export function renderToSimpleStream<T extends SimpleReadable>(
   // provide the ssr context to the tree
   input.provide(ssrContextKey, context)
 
+  const {
+    highWaterMark = DEFAULT_HIGH_WATER_MARK,
+    outOfOrder,
+    nonce
+  } = options
+  const writer = createChunkWriter(chunk => stream.push(chunk), highWaterMark)
+  let boundaries: SSRBuffer[] | undefined
+  if (outOfOrder) {
+    boundaries = context.__suspenseBoundaries = []
+  }
+
   Promise.resolve(renderComponentVNode(vnode))
-    .then(buffer => unrollBuffer(buffer, stream))
-    .then(() => stream.push(null))
+    .then(buffer => unrollBuffer(buffer, writer))
+    .then(
+      () => boundaries && renderSuspenseBoundaries(boundaries, writer, nonce)
+    )
+    .then(() => {
+      writer.end()
+      stream.push(null)
+    })
     .catch(error => {
       stream.destroy(error)
     })
@@ -97,10 +169,13 @@ export function renderToStream(
 
 export function renderToNodeStream(
   input: App | VNode,
-  context: SSRContext = {}
+  context: SSRContext = {},
+  options?: SSRStreamOptions
 ): Readable {
+  // content is pushed as it is rendered, so reads have nothing to do. Without
+  // read(), a consumer reading while content is pending errors the stream
   const stream: Readable = __NODE_JS__
-    ? new (require('stream').Readable)()
+    ? new (require('stream').Readable)({ read() {} })
     : null
 
   if (!stream) {
@@ -111,31 +186,38 @@ export function renderToNodeStream(
     )
   }
 
-  return renderToSimpleStream(input, context, stream)
+  return renderToSimpleStream(input, context, stream, options)
 }
 
 export function pipeToNodeWritable(
   input: App | VNode,
   context: SSRContext = {},
-  writable: Writable
+  writable: Writable,
+  options?: SSRStreamOptions
 ) {
-  renderToSimpleStream(input, context, {
-    push(content) {
-      if (content != null) {
-        writable.write(content)
-      } else {
-        writable.end()
+  renderToSimpleStream(
+    input,
+    context,
+    {
+      push(content) {
+        if (content != null) {
+          writable.write(content)
+        } else {
+          writable.end()
+        }
+      },
+      destroy(err) {
+        writable.destroy(err)
       }
     },
-    destroy(err) {
-      writable.destroy(err)
-    }
-  })
+    options
+  )
 }
 
 export function renderToWebStream(
   input: App | VNode,
-  context: SSRContext = {}
+  context: SSRContext = {},
+  options?: SSRStreamOptions
 ): ReadableStream {
   if (typeof ReadableStream !== 'function') {
     throw new Error(
@@ -150,19 +232,24 @@ export function renderToWebStream(
 
   return new ReadableStream({
     start(controller) {
-      renderToSimpleStream(input, context, {
-        push(content) {
-          if (cancelled) return
-          if (content != null) {
-            controller.enqueue(encoder.encode(content))
-          } else {
-            controller.close()
+      renderToSimpleStream(
+        input,
+        context,
+        {
+          push(content) {
+            if (cancelled) return
+            if (content != null) {
+              controller.enqueue(encoder.encode(content))
+            } else {
+              controller.close()
+            }
+          },
+          destroy(err) {
+            controller.error(err)
           }
         },
-        destroy(err) {
-          controller.error(err)
-        }
-      })
+        options
+      )
     },
     cancel() {
       cancelled = true
@@ -173,7 +260,8 @@ export function renderToWebStream(
 export function pipeToWebWritable(
   input: App | VNode,
   context: SSRContext = {},
-  writable: WritableStream
+  writable: WritableStream,
+  options?: SSRStreamOptions
 ): void {
   const writer = writable.getWriter()
   const encoder = new TextEncoder()
@@ -184,21 +272,26 @@ export function pipeToWebWritable(
     hasReady = isPromise(writer.ready)
   } catch (e: any) {}
 
-  renderToSimpleStream(input, context, {
-    async push(content) {
-      if (hasReady) {
-        await writer.ready
-      }
-      if (content != null) {
-        return writer.write(encoder.encode(content))
-      } else {
-        return writer.close()
+  renderToSimpleStream(
+    input,
+    context,
+    {
+      async push(content) {
+        if (hasReady) {
+          await writer.ready
+        }
+        if (content != null) {
+          return writer.write(encoder.encode(content))
+        } else {
+          return writer.close()
+        }
+      },
+      destroy(err) {
+        // TODO better error handling?
+        console.log(err)
+        writer.close()
       }
     },
-    destroy(err) {
-      // TODO better error handling?
-      console.log(err)
-      writer.close()
-    }
-  })
+    options
+  )
 }
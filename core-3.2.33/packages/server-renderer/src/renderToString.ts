@@ -6,47 +6,11 @@ import {
   ssrUtils,
   VNode
 } from 'vue'
-import { isPromise, isString } from '@vue/shared'
 import { SSRContext, renderComponentVNode, SSRBuffer } from './render'
+import { unrollBufferToString } from './unrollBuffer'
 
 const { isVNode } = ssrUtils
 
-async function unrollBuffer(buffer: SSRBuffer): Promise<string> {
-  if (buffer.hasAsync) {
-    let ret = ''
-    for (let i = 0; i < buffer.length; i++) {
-      let item = buffer[i]
-      if (isPromise(item)) {
-        item = await item
-      }
-      if (isString(item)) {
-        ret += item
-      } else {
-        ret += await unrollBuffer(item)
-      }
-    }
-    return ret
-  } else {
-    // sync buffer can be more efficiently unrolled without unnecessary await
-    // ticks
-    return unrollBufferSync(buffer)
-  }
-}
-
-function unrollBufferSync(buffer: SSRBuffer): string {
-  let ret = ''
-  for (let i = 0; i < buffer.length; i++) {
-    let item = buffer[i]
-    if (isString(item)) {
-      ret += item
-    } else {
-      // since this is a sync buffer, child buffers are never promises
-      ret += unrollBufferSync(item as SSRBuffer)
-    }
-  }
-  return ret
-}
-
 export async function renderToString(
   input: App | VNode,
   context: SSRContext = {}
@@ -65,16 +29,16 @@ export async function renderToString(
 
   await resolveTeleports(context)
 
-  return unrollBuffer(buffer as SSRBuffer)
+  return unrollBufferToString(buffer as SSRBuffer)
 }
 
-async function resolveTeleports(context: SSRContext) {
+export async function resolveTeleports(context: SSRContext) {
   if (context.__teleportBuffers) {
     context.teleports = context.teleports || {}
     for (const key in context.__teleportBuffers) {
       // note: it's OK to await sequentially here because the Promises were
       // created eagerly in parallel.
-      context.teleports[key] = await unrollBuffer(
+      context.teleports[key] = await unrollBufferToString(
         (await Promise.all(context.__teleportBuffers[key])) as SSRBuffer
       )
     }
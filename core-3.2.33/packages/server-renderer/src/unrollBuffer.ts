@@ -0,0 +1,163 @@
+import { isPromise, isString } from '@vue/shared'
+import { SSRBuffer, SSRBufferItem } from './render'
+
+export interface SSRWriter {
+  write(chunk: string): void
+  // called before the unroller waits on an async buffer item, so that
+  // everything rendered so far can be sent out early
+  flush(): void
+}
+
+// Arrays used to collect pending chunks are recycled across renders so that
+// a busy server does not grow a fresh array (and its backing store) for
+// every request.
+const MAX_POOLED_CHUNK_LISTS = 32
+const chunkListPool: string[][] = []
+
+function acquireChunkList(): string[] {
+  return chunkListPool.pop() || []
+}
+
+function releaseChunkList(list: string[]) {
+  list.length = 0
+  if (chunkListPool.length < MAX_POOLED_CHUNK_LISTS) {
+    chunkListPool.push(list)
+  }
+}
+
+/**
+ * Collects all chunks and joins them once at the end, instead of growing a
+ * single string with `+=` for every buffer item.
+ */
+export function createStringWriter() {
+  let chunks = acquireChunkList()
+  return {
+    write(chunk: string) {
+      chunks.push(chunk)
+    },
+    flush() {},
+    end(): string {
+      const ret = chunks.length === 1 ? chunks[0] : chunks.join('')
+      releaseChunkList(chunks)
+      chunks = null as any
+      return ret
+    }
+  }
+}
+
+/**
+ * Coalesces chunks until at least `highWaterMark` characters are pending and
+ * then pushes them to the sink as a single chunk. With a high water mark of
+ * 0 every chunk is pushed as is.
+ */
+export function createChunkWriter(
+  push: (chunk: string) => void,
+  highWaterMark: number
+) {
+  let chunks = acquireChunkList()
+  let size = 0
+
+  function flush() {
+    if (chunks.length) {
+      const chunk = chunks.length === 1 ? chunks[0] : chunks.join('')
+      chunks.length = size = 0
+      push(chunk)
+    }
+  }
+
+  return {
+    write(chunk: string) {
+      if (!chunk) {
+        return
+      }
+      if (highWaterMark <= 0) {
+        push(chunk)
+        return
+      }
+      chunks.push(chunk)
+      if ((size += chunk.length) >= highWaterMark) {
+        flush()
+      }
+    },
+    flush,
+    end() {
+      flush()
+      releaseChunkList(chunks)
+      chunks = null as any
+    }
+  }
+}
+
+/**
+ * Walks the buffer tree depth-first with an explicit stack and writes every
+ * string in order. Async items are only awaited when actually encountered,
+ * so a fully sync tree is unrolled without any await ticks.
+ */
+export async function unrollBuffer(
+  buffer: SSRBuffer,
+  writer: SSRWriter
+): Promise<void> {
+  const buffers: SSRBuffer[] = [buffer]
+  const indices: number[] = [0]
+  let depth = 0
+  while (depth >= 0) {
+    const current = buffers[depth]
+    const i = indices[depth]
+    if (i === current.length) {
+      depth--
+      continue
+    }
+    indices[depth] = i + 1
+    let item: SSRBufferItem = current[i]
+    if (isString(item)) {
+      writer.write(item)
+      continue
+    }
+    if (isPromise(item)) {
+      writer.flush()
+      item = await item
+      if (isString(item)) {
+        writer.write(item)
+        continue
+      }
+    }
+    buffers[++depth] = item
+    indices[depth] = 0
+  }
+}
+
+export async function unrollBufferToString(
+  buffer: SSRBuffer
+): Promise<string> {
+  const writer = createStringWriter()
+  await unrollBuffer(buffer, writer)
+  return writer.end()
+}
+
+/**
+ * Same as `unrollBufferToString()`, but for buffers without async items.
+ */
+export function unrollBufferSync(buffer: SSRBuffer): string {
+  const writer = createStringWriter()
+  const buffers: SSRBuffer[] = [buffer]
+  const indices: number[] = [0]
+  let depth = 0
+  while (depth >= 0) {
+    const current = buffers[depth]
+    const i = indices[depth]
+    if (i === current.length) {
+      depth--
+      continue
+    }
+    indices[depth] = i + 1
+    const item = current[i]
+    if (isString(item)) {
+      writer.write(item)
+    } else {
+      // since this is a sync buffer, child buffers are never promises
+      buffers[++depth] = item as SSRBuffer
+      indices[depth] = 0
+    }
+  }
+  return writer.end()
+}
@@ -0,0 +1,501 @@
+import { App, warn } from 'vue'
+import { extend, isFunction, isObject } from '@vue/shared'
+import { SSRContext } from './render'
+import { renderToString, resolveTeleports } from './renderToString'
+import { renderToSimpleStream, SSRStreamOptions } from './renderToStream'
+import { configureSSRCompileCache } from './helpers/ssrCompile'
+import type { Readable } from 'stream'
+import type { Worker } from 'worker_threads'
+
+export interface SSRWorkerPoolOptions {
+  /**
+   * Number of worker threads.
+   * @default the number of CPUs
+   */
+  threads?: number
+  /**
+   * Directory for the persistent compile cache (see
+   * `configureSSRCompileCache()`), shared by all workers so that each
+   * template is only compiled once across the pool.
+   */
+  compileCacheDir?: string
+  /**
+   * Options for `renderToNodeStream()` calls.
+   */
+  streamOptions?: SSRStreamOptions
+  /**
+   * Path of the module the workers load the renderer from. Must be set when
+   * the renderer is bundled into the server code, since the workers cannot
+   * load it from the bundle.
+   * @default the `@vue/server-renderer` package entry
+   */
+  rendererPath?: string
+}
+
+export interface SSRLatencyHistogram {
+  /**
+   * Upper bounds of the buckets in milliseconds. The last bucket has no
+   * upper bound.
+   */
+  bounds: number[]
+  counts: number[]
+  count: number
+  /**
+   * Sum, min and max of all recorded latencies in milliseconds
+   */
+  sum: number
+  min: number
+  max: number
+  /**
+   * Approximate percentiles: the upper bound of the bucket the percentile
+   * falls into (or the max for the last bucket)
+   */
+  p50: number
+  p90: number
+  p99: number
+}
+
+export interface SSRWorkerStats {
+  threadId: number
+  /**
+   * Number of requests currently dispatched to this worker
+   */
+  active: number
+  completed: number
+  failed: number
+  latency: SSRLatencyHistogram
+}
+
+export interface SSRWorkerPool {
+  /**
+   * Renders the app created by the app factory in a worker. Properties of
+   * `context` that can be structured cloned are passed to the worker, except
+   * `componentCache` (see `serializeContext()`), and the context populated
+   * during rendering (e.g. `teleports`, `modules`) is copied back onto it
+   * before the returned promise resolves.
+   */
+  renderToString(context?: SSRContext): Promise<string>
+  /**
+   * Same as `renderToString()`, but streams the output. The context is
+   * updated before the stream ends.
+   */
+  renderToNodeStream(context?: SSRContext): Readable
+  stats(): SSRWorkerStats[]
+  close(): Promise<void>
+}
+
+type AppFactory = (context: SSRContext) => App | Promise<App>
+
+// main -> worker
+interface WorkerRequest {
+  id: number
+  type: 'string' | 'stream'
+  context: SSRContext
+}
+
+// worker -> main
+type WorkerMessage =
+  | { id: number; type: 'chunk'; chunk: Uint8Array }
+  | { id: number; type: 'done'; html?: Uint8Array; context: SSRContext }
+  | { id: number; type: 'error'; message: string; stack?: string }
+
+type DoneMessage = Extract<WorkerMessage, { type: 'done' }>
+
+interface Job {
+  context: SSRContext
+  start: number
+  onChunk?: (chunk: Uint8Array) => void
+  resolve: (html: string | undefined) => void
+  reject: (err: Error) => void
+}
+
+interface PoolWorker {
+  worker: Worker
+  jobs: Map<number, Job>
+  completed: number
+  failed: number
+  latency: LatencyRecorder
+}
+
+// Evaluated as the worker's entry. Kept as a string so that the dynamic
+// import used to load ESM app factories survives bundling.
+const WORKER_SCRIPT =
+  `const { workerData } = require('worker_threads')\n` +
+  `require(workerData.rendererPath).ssrRunWorker(p => import(p))`
+
+/**
+ * Creates a pool of worker threads that render the app exported by the
+ * `appFactory` module - a function receiving the SSR context and returning
+ * an app (or a promise of one), as default or `module.exports` export.
+ */
+export function createSSRWorkerPool(
+  appFactory: string,
+  options: SSRWorkerPoolOptions = {}
+): SSRWorkerPool {
+  if (!__NODE_JS__) {
+    throw new Error(
+      `createSSRWorkerPool() is only supported in the Node.js build of ` +
+        `@vue/server-renderer.`
+    )
+  }
+
+  const { Worker } = require('worker_threads')
+  const { pathToFileURL } = require('url')
+  const path = require('path')
+  const threads = options.threads || require('os').cpus().length || 1
+  const workerData = {
+    rendererPath:
+      options.rendererPath || require.resolve('@vue/server-renderer'),
+    appFactory: pathToFileURL(path.resolve(appFactory)).href,
+    compileCacheDir: options.compileCacheDir,
+    streamOptions: options.streamOptions
+  }
+
+  const workers: PoolWorker[] = []
+  let uid = 0
+  let closed = false
+
+  function spawn(index: number) {
+    const poolWorker: PoolWorker = {
+      worker: new Worker(WORKER_SCRIPT, { eval: true, workerData }),
+      jobs: new Map(),
+      completed: 0,
+      failed: 0,
+      latency: createLatencyRecorder()
+    }
+    const { worker, jobs } = poolWorker
+    // do not keep the process alive just for idle workers
+    worker.unref()
+
+    worker.on('message', (msg: WorkerMessage) => {
+      const job = jobs.get(msg.id)
+      if (!job) return
+      if (msg.type === 'chunk') {
+        job.onChunk!(msg.chunk)
+        return
+      }
+      jobs.delete(msg.id)
+      if (!jobs.size) worker.unref()
+      poolWorker.latency.record(now() - job.start)
+      if (msg.type === 'done') {
+        poolWorker.completed++
+        extend(job.context, msg.context)
+        job.resolve(msg.html && decoder.decode(msg.html))
+      } else {
+        poolWorker.failed++
+        const err = new Error(msg.message)
+        if (msg.stack) err.stack = msg.stack
+        job.reject(err)
+      }
+    })
+
+    const onExit = (err?: Error) => {
+      if (workers[index] !== poolWorker) return
+      const error =
+        err ||
+        new Error(
+          closed
+            ? `SSR worker pool has been closed.`
+            : `SSR worker ${worker.threadId} exited unexpectedly.`
+        )
+      jobs.forEach(job => job.reject(error))
+      poolWorker.failed += jobs.size
+      jobs.clear()
+      if (!closed) {
+        spawn(index)
+      }
+    }
+    worker.on('error', onExit)
+    worker.on('exit', () => onExit())
+
+    workers[index] = poolWorker
+  }
+
+  for (let i = 0; i < threads; i++) {
+    spawn(i)
+  }
+
+  function dispatch(
+    type: 'string' | 'stream',
+    context: SSRContext,
+    job: Omit<Job, 'context' | 'start'>
+  ) {
+    if (closed) {
+      job.reject(new Error(`SSR worker pool has been closed.`))
+      return
+    }
+    // least busy worker
+    let target = workers[0]
+    for (let i = 1; i < workers.length; i++) {
+      if (workers[i].jobs.size < target.jobs.size) target = workers[i]
+    }
+    const id = uid++
+    try {
+      postWithContext<WorkerRequest>(msg => target.worker.postMessage(msg), {
+        id,
+        type,
+        context
+      })
+    } catch (e: any) {
+      job.reject(e)
+      return
+    }
+    target.jobs.set(id, extend({ context, start: now() }, job))
+    target.worker.ref()
+  }
+
+  return {
+    renderToString(context = {}) {
+      return new Promise<string>((resolve, reject) => {
+        dispatch('string', context, {
+          resolve: html => resolve(html!),
+          reject
+        })
+      })
+    },
+
+    renderToNodeStream(context = {}) {
+      const stream: Readable = new (require('stream').Readable)({
+        read() {}
+      })
+      dispatch('stream', context, {
+        onChunk: chunk => {
+          stream.push(
+            Buffer.from(chunk.buffer, chunk.byteOffset, chunk.byteLength)
+          )
+        },
+        resolve: () => stream.push(null),
+        reject: err => stream.destroy(err)
+      })
+      return stream
+    },
+
+    stats() {
+      return workers.map(({ worker, jobs, completed, failed, latency }) => ({
+        threadId: worker.threadId,
+        active: jobs.size,
+        completed,
+        failed,
+        latency: latency.snapshot()
+      }))
+    },
+
+    async close() {
+      closed = true
+      await Promise.all(workers.map(({ worker }) => worker.terminate()))
+    }
+  }
+}
+
+/**
+ * Entry of pool workers.
+ * @internal
+ */
+export function ssrRunWorker(load: (url: string) => Promise<any>) {
+  const { parentPort, workerData } = require('worker_threads')
+  const { appFactory, compileCacheDir, streamOptions } = workerData
+
+  if (compileCacheDir) {
+    configureSSRCompileCache({ cacheDir: compileCacheDir })
+  }
+
+  const factory: Promise<AppFactory> = load(appFactory).then(mod => {
+    // ESM default export, module.exports or transpiled default export
+    const fn = mod.default || mod
+    return isFunction(fn) ? fn : fn.default
+  })
+
+  parentPort.on('message', (req: WorkerRequest) =>
+    renderRequest(
+      factory,
+      req,
+      (msg, transfer) => parentPort.postMessage(msg, transfer),
+      streamOptions
+    )
+  )
+}
+
+/**
+ * Renders a single request inside a worker. Output is sent as UTF-8
+ * encoded buffers whose memory is transferred to the main thread.
+ * @internal
+ */
+export async function renderRequest(
+  factory: AppFactory | Promise<AppFactory>,
+  { id, type, context }: WorkerRequest,
+  post: (msg: WorkerMessage, transfer?: ArrayBuffer[]) => void,
+  streamOptions?: SSRStreamOptions
+) {
+  try {
+    const app = await (await factory)(context)
+    if (type === 'string') {
+      const html = encoder.encode(await renderToString(app, context))
+      postWithContext<DoneMessage>(msg => post(msg, [html.buffer]), {
+        id,
+        type: 'done',
+        html,
+        context
+      })
+    } else {
+      await new Promise<void>((resolve, reject) => {
+        renderToSimpleStream(
+          app,
+          context,
+          {
+            push(content) {
+              if (content == null) {
+                resolve()
+              } else {
+                const chunk = encoder.encode(content)
+                post({ id, type: 'chunk', chunk }, [chunk.buffer])
+              }
+            },
+            destroy: reject
+          },
+          streamOptions
+        )
+      })
+      // streams do not expose teleports, but the caller on the other side
+      // of the boundary has no other way to get them
+      await resolveTeleports(context)
+      postWithContext<DoneMessage>(post, { id, type: 'done', context })
+    }
+  } catch (e: any) {
+    post({
+      id,
+      type: 'error',
+      message: e instanceof Error ? e.message : String(e),
+      stack: e instanceof Error ? e.stack : undefined
+    })
+  }
+}
+
+const encoder = new TextEncoder()
+const decoder = new TextDecoder()
+
+/**
+ * Posts a message holding an SSR context (see `serializeContext()`). Values
+ * are only checked one by one if the context fails to clone.
+ * @internal
+ */
+export function postWithContext<T extends { context: SSRContext }>(
+  post: (msg: T) => void,
+  msg: T
+) {
+  msg.context = serializeContext(msg.context)
+  try {
+    post(msg)
+  } catch (e: any) {
+    if (!e || e.name !== 'DataCloneError') {
+      throw e
+    }
+    msg.context = serializeContext(msg.context, true)
+    post(msg)
+  }
+}
+
+/**
+ * Copies the parts of an SSR context that can cross a thread boundary.
+ * Internal (`__` prefixed) properties and functions are left out, and so is
+ * the `componentCache`, whose methods cannot be called from another thread,
+ * with a warning in dev. With `probe`, so is any other value that cannot be
+ * structured cloned.
+ * @internal
+ */
+export function serializeContext(
+  context: SSRContext,
+  probe = false
+): SSRContext {
+  const ret: SSRContext = {}
+  for (const key in context) {
+    const value = context[key]
+    if (key.startsWith('__') || isFunction(value)) {
+      continue
+    }
+    if (key !== 'componentCache' && (!probe || isCloneable(value))) {
+      ret[key] = value
+    } else if (__DEV__) {
+      warn(
+        `SSR context property "${key}" cannot be passed to a worker thread ` +
+          `and is left out.`
+      )
+    }
+  }
+  return ret
+}
+
+function isCloneable(value: unknown): boolean {
+  if (!isObject(value)) {
+    return typeof value !== 'symbol'
+  }
+  try {
+    // the serializer postMessage() uses
+    require('v8').serialize(value)
+    return true
+  } catch (e) {
+    return false
+  }
+}
+
+// latency buckets in ms
+const LATENCY_BOUNDS = [1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000]
+
+interface LatencyRecorder {
+  record(ms: number): void
+  snapshot(): SSRLatencyHistogram
+}
+
+/**
+ * @internal
+ */
+export function createLatencyRecorder(): LatencyRecorder {
+  const counts: number[] = new Array(LATENCY_BOUNDS.length + 1).fill(0)
+  let count = 0
+  let sum = 0
+  let min = Infinity
+  let max = 0
+
+  function percentile(p: number) {
+    if (!count) return 0
+    const rank = Math.ceil(count * p)
+    let seen = 0
+    for (let i = 0; i < counts.length; i++) {
+      if ((seen += counts[i]) >= rank) {
+        return i < LATENCY_BOUNDS.length
+          ? Math.min(LATENCY_BOUNDS[i], max)
+          : max
+      }
+    }
+    return max
+  }
+
+  return {
+    record(ms) {
+      let i = 0
+      while (i < LATENCY_BOUNDS.length && ms > LATENCY_BOUNDS[i]) i++
+      counts[i]++
+      count++
+      sum += ms
+      if (ms < min) min = ms
+      if (ms > max) max = ms
+    },
+    snapshot() {
+      return {
+        bounds: LATENCY_BOUNDS.slice(),
+        counts: counts.slice(),
+        count,
+        sum,
+        min: count ? min : 0,
+        max,
+        p50: percentile(0.5),
+        p90: percentile(0.9),
+        p99: percentile(0.99)
+      }
+    }
+  }
+}
+
+function now() {
+  const [s, ns] = process.hrtime()
+  return s * 1e3 + ns / 1e6
+}
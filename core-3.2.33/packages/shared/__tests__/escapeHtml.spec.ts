@@ -9,3 +9,31 @@ test('ssr: escapeHTML', () => {
   expect(escapeHtml(`'bar'`)).toBe(`&#39;bar&#39;`)
   expect(escapeHtml(`<div>`)).toBe(`&lt;div&gt;`)
 })
+
+test('ssr: escapeHTML on long text', () => {
+  const reference = (str: string) =>
+    str.replace(
+      /["'&<>]/g,
+      ch =>
+        ({
+          '"': '&quot;',
+          '&': '&amp;',
+          "'": '&#39;',
+          '<': '&lt;',
+          '>': '&gt;'
+        }[ch]!)
+    )
+
+  const clean = 'lorem ipsum dolor sit amet '.repeat(100)
+  expect(escapeHtml(clean)).toBe(clean)
+  // escapable characters at various distances, including across the inline
+  // scan window and at both ends
+  for (const gap of [0, 1, 31, 32, 33, 100]) {
+    const text = `<${'a'.repeat(gap)}&${'b'.repeat(gap)}"'${clean}>`
+    expect(escapeHtml(text)).toBe(reference(text))
+  }
+  const markup = `<div class="a">x & 'y'</div>`.repeat(50)
+  expect(escapeHtml(markup)).toBe(reference(markup))
+  const trailing = clean + '&'
+  expect(escapeHtml(trailing)).toBe(clean + '&amp;')
+})
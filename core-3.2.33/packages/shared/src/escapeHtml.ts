@@ -1,4 +1,11 @@
 const escapeRE = /["'&<>]/
+const escapeGlobalRE = /["'&<>]/g
+
+// Once this many characters have been scanned since the last escaped one,
+// the rest of the clean run is skipped with the regex engine, which is much
+// faster than a charCodeAt loop on long text. Markup-like text, with
+// escapable characters close together, stays on the loop.
+const SCAN_WINDOW = 32
 
 export function escapeHtml(string: unknown) {
   const str = '' + string
@@ -30,6 +37,13 @@ export function escapeHtml(string: unknown) {
         escaped = '&gt;'
         break
       default:
+        if (index - lastIndex >= SCAN_WINDOW) {
+          escapeGlobalRE.lastIndex = index
+          const next = escapeGlobalRE.exec(str)
+          // resume right before the next match (the loop increments it), or
+          // finish if there is none
+          index = (next ? next.index : str.length) - 1
+        }
         continue
     }
 
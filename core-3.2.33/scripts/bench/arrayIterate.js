@@ -0,0 +1,44 @@
+/*
+Memory and time of effects running search / iteration methods on a large
+reactive array, e.g. a selection check or a derived list in a data grid.
+
+```
+node scripts/build.js reactivity -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/arrayIterate.js
+```
+*/
+
+const { reactive, effect, stop } = require(process.env.REACTIVITY ||
+  '../../packages/reactivity')
+const { bench, heapUsed } = require('./utils')
+
+const SIZE = +process.env.SIZE || 100000
+
+const list = reactive(
+  Array.from({ length: SIZE }, (_, i) => ({ id: i, done: i % 3 === 0 }))
+)
+
+// create the element proxies up front, so only tracking is measured
+for (let i = 0; i < SIZE; i++) list[i]
+
+// callbacks that read element properties also track those properties
+const methods = {
+  indexOf: () => list.indexOf(null),
+  includes: () => list.includes(null),
+  find: () => list.find(item => item.id === -1),
+  filter: () => list.filter(item => item.done),
+  map: () => list.map(item => item.id),
+  reduce: () => list.reduce((sum, item) => sum + item.id, 0)
+}
+
+for (const name in methods) {
+  const before = heapUsed()
+  const runner = effect(methods[name])
+  const after = heapUsed()
+  console.log(
+    `${name.padEnd(10)} ${SIZE} items: ` +
+      `${((after - before) / 1024).toFixed(0)} KB retained by tracking`
+  )
+  bench(`  re-run ${name}`, runner, { minTime: 300 })
+  stop(runner)
+}
@@ -0,0 +1,49 @@
+/*
+Bulk imports into observed reactive collections, with and without `batch()`.
+The effects stand in for a sync watcher on the collection size and for a
+render effect iterating the collection.
+
+```
+node scripts/build.js reactivity -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/batch.js
+```
+*/
+
+const { reactive, effect, stop, batch } = require(process.env.REACTIVITY ||
+  '../../packages/reactivity')
+const { bench } = require('./utils')
+
+const ROWS = +process.env.ROWS || 50000
+const rows = []
+for (let i = 0; i < ROWS; i++) {
+  rows.push({ id: i, label: `row ${i}` })
+}
+
+const run = fn => fn()
+
+function importArray(wrap) {
+  const list = reactive([])
+  const size = effect(() => list.length)
+  const last = effect(() => list[list.length - 1])
+  wrap(() => {
+    for (const row of rows) list.push(row)
+  })
+  stop(size)
+  stop(last)
+}
+
+function importMap(wrap) {
+  const map = reactive(new Map())
+  const size = effect(() => map.size)
+  const keys = effect(() => map.keys())
+  wrap(() => {
+    for (const row of rows) map.set(row.id, row)
+  })
+  stop(size)
+  stop(keys)
+}
+
+bench(`array push ${ROWS}`, () => importArray(run))
+bench(`array push ${ROWS} (batch)`, () => importArray(batch))
+bench(`map set ${ROWS}`, () => importMap(run))
+bench(`map set ${ROWS} (batch)`, () => importMap(batch))
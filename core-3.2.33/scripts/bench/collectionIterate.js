@@ -0,0 +1,44 @@
+/*
+Throughput of iterating a large reactive Map, e.g. a client-side cache of
+records, compared to the raw Map: the default reactive iteration wraps every
+key and value, `shallowReactive` and `iterateRaw()` yield them as stored.
+
+```
+node scripts/build.js reactivity -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/collectionIterate.js
+```
+*/
+
+const { reactive, shallowReactive, iterateRaw } = require(process.env
+  .REACTIVITY || '../../packages/reactivity')
+const { bench } = require('./utils')
+
+const SIZE = +process.env.SIZE || 200000
+
+const raw = new Map()
+for (let i = 0; i < SIZE; i++) {
+  raw.set(i, { id: i, label: `record ${i}` })
+}
+const map = reactive(raw)
+const shallowMap = shallowReactive(new Map(raw))
+
+function sumOf(entries) {
+  let sum = 0
+  for (const [, record] of entries) sum += record.id
+  return sum
+}
+
+bench(`raw Map for..of ${SIZE}`, () => sumOf(raw))
+bench(`reactive for..of ${SIZE}`, () => sumOf(map))
+bench(`reactive forEach ${SIZE}`, () => {
+  let sum = 0
+  map.forEach(record => (sum += record.id))
+  return sum
+})
+bench(`shallowReactive for..of ${SIZE}`, () => sumOf(shallowMap))
+bench(`iterateRaw(reactive) ${SIZE}`, () => sumOf(iterateRaw(map)))
+bench(`iterateRaw(reactive, 'values') ${SIZE}`, () => {
+  let sum = 0
+  for (const record of iterateRaw(map, 'values')) sum += record.id
+  return sum
+})
@@ -0,0 +1,42 @@
+/*
+Measures how the cost of re-evaluating a chain of nested computeds scales
+with the nesting depth, like in formula engines where a cell depends on a
+cell that depends on a cell... Each level reads two sources so that the deps
+are diffed on every run. The cost per level should stay flat.
+
+```
+node scripts/build.js reactivity -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/effectDepth.js
+```
+*/
+
+const { ref, computed, effect, stop } = require(process.env.REACTIVITY ||
+  '../../packages/reactivity')
+const { bench } = require('./utils')
+
+const DEPTHS = [1, 10, 20, 30, 31, 40, 50, 100, 150, 200]
+
+for (const depth of DEPTHS) {
+  const source = ref(0)
+  const offset = ref(1)
+  let c = computed(() => source.value)
+  for (let i = 0; i < depth; i++) {
+    const prev = c
+    c = computed(() => prev.value + offset.value)
+  }
+  const runner = effect(() => c.value)
+
+  // re-evaluate the whole chain often enough for a stable measurement
+  const updates = Math.ceil(20000 / depth)
+  const { mean } = bench(
+    `depth ${depth}`,
+    () => {
+      for (let i = 0; i < updates; i++) source.value++
+    },
+    { minTime: 300 }
+  )
+  console.log(
+    `${''.padEnd(40)} ${((mean * 1e6) / updates / depth).toFixed(1)} ns/level`
+  )
+  stop(runner)
+}
@@ -0,0 +1,96 @@
+/*
+Compares `escapeHtml` from @vue/shared against the previous character by
+character implementation on text shaped like SSR interpolations: short
+values, long user-generated text with few escapable characters, and dense
+markup-like text.
+
+```
+node scripts/build.js shared -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/escapeHtml.js
+```
+*/
+
+const { escapeHtml } = require(process.env.SHARED || "../../packages/shared")
+const { bench } = require('./utils')
+
+const escapeRE = /["'&<>]/
+
+function escapeHtmlCharLoop(string) {
+  const str = '' + string
+  const match = escapeRE.exec(str)
+
+  if (!match) {
+    return str
+  }
+
+  let html = ''
+  let escaped
+  let index
+  let lastIndex = 0
+  for (index = match.index; index < str.length; index++) {
+    switch (str.charCodeAt(index)) {
+      case 34: // "
+        escaped = '&quot;'
+        break
+      case 38: // &
+        escaped = '&amp;'
+        break
+      case 39: // '
+        escaped = '&#39;'
+        break
+      case 60: // <
+        escaped = '&lt;'
+        break
+      case 62: // >
+        escaped = '&gt;'
+        break
+      default:
+        continue
+    }
+
+    if (lastIndex !== index) {
+      html += str.slice(lastIndex, index)
+    }
+
+    lastIndex = index + 1
+    html += escaped
+  }
+
+  return lastIndex !== index ? html + str.slice(lastIndex, index) : html
+}
+
+const sentence =
+  'The battery life is great and the screen is sharp enough for reading ' +
+  'in direct sunlight, although the speakers are a bit quiet. '
+
+function createReview(size) {
+  let text = ''
+  while (text.length < size) {
+    text += sentence
+    // an occasional quote or ampersand, as in real reviews
+    if (text.length % 7 === 0) text += `"Q&A" `
+  }
+  return text
+}
+
+const inputs = {
+  'short value': `Tom & "Jerry"`,
+  'review 1KB': createReview(1024),
+  'review 64KB': createReview(64 * 1024),
+  'review 1MB': createReview(1024 * 1024),
+  'markup 64KB': `<p class="note">a &amp; b</p>`.repeat(2048)
+}
+
+for (const name in inputs) {
+  const input = inputs[name]
+  if (escapeHtml(input) !== escapeHtmlCharLoop(input)) {
+    throw new Error(`output mismatch for ${name}`)
+  }
+  const short = input.length < 4096
+  const run = fn => () => {
+    for (let i = 0; i < (short ? 1000 : 1); i++) fn(input)
+  }
+  const { mean: before } = bench(`char loop: ${name}`, run(escapeHtmlCharLoop))
+  const { mean: after } = bench(`escapeHtml: ${name}`, run(escapeHtml))
+  console.log(`  x${(before / after).toFixed(2)} faster`)
+}
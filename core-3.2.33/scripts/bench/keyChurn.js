@@ -0,0 +1,48 @@
+/*
+Retained heap of long-lived reactive objects whose keys churn, e.g. a keyed
+cache read by an effect: every key is observed for a while and then dropped.
+Deps of keys without subscribers should not accumulate.
+
+```
+node scripts/build.js reactivity -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/keyChurn.js
+```
+*/
+
+const { reactive, ref, effect, stop } = require(process.env.REACTIVITY ||
+  '../../packages/reactivity')
+const { heapUsed } = require('./utils')
+
+const CHURNS = +process.env.CHURNS || 1000000
+
+function churn(name, cache, { get, set, remove }) {
+  const id = ref(0)
+  const runner = effect(() => get(cache, id.value))
+  const before = heapUsed()
+  const start = Date.now()
+  for (let i = 1; i <= CHURNS; i++) {
+    set(cache, i)
+    id.value = i
+    remove(cache, i - 1)
+  }
+  const elapsed = Date.now() - start
+  const after = heapUsed()
+  console.log(
+    `${name.padEnd(8)} ${CHURNS} key churns: ` +
+      `${((after - before) / 1024 / 1024).toFixed(1).padStart(6)} MB retained` +
+      `  ${elapsed} ms`
+  )
+  stop(runner)
+}
+
+churn('object', reactive({}), {
+  get: (obj, key) => obj[key],
+  set: (obj, key) => (obj[key] = key),
+  remove: (obj, key) => delete obj[key]
+})
+
+churn('Map', reactive(new Map()), {
+  get: (map, key) => map.get(key),
+  set: (map, key) => map.set(key, key),
+  remove: (map, key) => map.delete(key)
+})
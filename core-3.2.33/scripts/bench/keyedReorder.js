@@ -0,0 +1,144 @@
+/*
+Keyed reorders of a large list, e.g. a sortable table re-sorted by another
+column. Every render moves most rows, so it runs the longest increasing
+subsequence pass of the keyed diff. The rows are rendered with a minimal
+linked-list host whose node ops are O(1), so that the diff is what is
+measured. The GC count is a proxy for how much the renders allocate, and
+the host insert calls are the DOM mutations a reorder would cause.
+
+```
+node scripts/build.js runtime-test -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/keyedReorder.js
+```
+*/
+
+const { PerformanceObserver } = require('perf_hooks')
+const { h, createRenderer } = require(process.env.RUNTIME_TEST ||
+  '../../packages/runtime-test')
+const { bench } = require('./utils')
+
+const ROWS = +process.env.ROWS || 5000
+
+const createNode = text => ({
+  text,
+  parent: null,
+  prev: null,
+  next: null,
+  first: null,
+  last: null
+})
+
+const detach = node => {
+  const parent = node.parent
+  if (!parent) return
+  if (node.prev) node.prev.next = node.next
+  else parent.first = node.next
+  if (node.next) node.next.prev = node.prev
+  else parent.last = node.prev
+  node.parent = node.prev = node.next = null
+}
+
+let hostInserts = 0
+
+function insert(node, parent, anchor) {
+  detach(node)
+  node.parent = parent
+  node.next = anchor || null
+  node.prev = anchor ? anchor.prev : parent.last
+  if (node.prev) node.prev.next = node
+  else parent.first = node
+  if (anchor) anchor.prev = node
+  else parent.last = node
+}
+
+const { render } = createRenderer({
+  insert(node, parent, anchor) {
+    hostInserts++
+    insert(node, parent, anchor)
+  },
+  insertMany(nodes, parent, anchor) {
+    hostInserts++
+    for (const node of nodes) insert(node, parent, anchor)
+  },
+  remove: detach,
+  createElement: createNode,
+  createText: createNode,
+  createComment: createNode,
+  setText(node, text) {
+    node.text = text
+  },
+  setElementText(node, text) {
+    node.first = node.last = null
+    node.text = text
+  },
+  parentNode: node => node.parent,
+  nextSibling: node => node.next,
+  patchProp() {}
+})
+
+let gcCount = 0
+new PerformanceObserver(list => {
+  gcCount += list.getEntries().length
+}).observe({ entryTypes: ['gc'] })
+
+const ids = Array.from({ length: ROWS }, (_, i) => i)
+
+// deterministic shuffles, so runs are comparable
+let seed = 1
+const random = () => (seed = (seed * 16807) % 2147483647) / 2147483647
+const shuffle = list => {
+  const copy = list.slice()
+  for (let i = copy.length - 1; i > 0; i--) {
+    const j = Math.floor(random() * (i + 1))
+    ;[copy[i], copy[j]] = [copy[j], copy[i]]
+  }
+  return copy
+}
+
+const asc = ids
+const desc = ids.slice().reverse()
+const shuffles = Array.from({ length: 8 }, () => shuffle(ids))
+const swapped = ids.slice()
+swapped[1] = ROWS - 2
+swapped[ROWS - 2] = 1
+
+const root = createNode('')
+const byNumber = id => id
+const byString = id => `row-${id}`
+
+function renderRows(order, toKey) {
+  render(
+    h(
+      'table',
+      order.map(id => h('tr', { key: toKey(id) }, [h('td', id)]))
+    ),
+    root
+  )
+}
+
+const cases = [
+  [`sort ${ROWS} rows asc / desc`, [asc, desc], byNumber],
+  [`shuffle ${ROWS} rows`, shuffles, byNumber],
+  [`swap 2 of ${ROWS} rows`, [asc, swapped], byNumber],
+  [`shuffle ${ROWS} rows (string keys)`, shuffles, byString]
+]
+
+;(async () => {
+  for (const [name, orders, toKey] of cases) {
+    renderRows(asc, toKey)
+    let i = 0
+    gcCount = 0
+    hostInserts = 0
+    const { iterations } = bench(name, () =>
+      renderRows(orders[i++ % orders.length], toKey)
+    )
+    // gc entries are delivered asynchronously
+    await new Promise(r => setTimeout(r))
+    console.log(
+      `${''.padEnd(40)} ${((gcCount * 100) / iterations).toFixed(1)} GCs` +
+        ` per 100 ops, ${Math.round(hostInserts / iterations)} host inserts` +
+        ` per op`
+    )
+    render(null, root)
+  }
+})()
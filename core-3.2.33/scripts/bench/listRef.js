@@ -0,0 +1,65 @@
+/*
+Replacing a large dataset rendered as a list of row components, e.g. on each
+poll of an API returning fresh objects where only a few rows changed:
+a shallowRef re-renders every row, a keyed listRef only the changed ones.
+
+```
+node scripts/build.js runtime-test -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/listRef.js
+```
+*/
+
+const { h, shallowRef, listRef, render, nodeOps, resetOps, nextTick } =
+  require(process.env.RUNTIME_TEST || '../../packages/runtime-test')
+const { benchAsync } = require('./utils')
+
+const ROWS = +process.env.ROWS || 10000
+const CHANGED = +process.env.CHANGED || 100
+
+let poll = 0
+// fresh objects for every row, as from JSON.parse()
+function fetchRows() {
+  poll++
+  return Array.from({ length: ROWS }, (_, id) => ({
+    id,
+    label: id % (ROWS / CHANGED) === 0 ? `row ${id} (${poll})` : `row ${id}`
+  }))
+}
+
+const Row = {
+  props: ['item'],
+  render() {
+    return h('tr', [h('td', this.item.id), h('td', this.item.label)])
+  }
+}
+
+function mountList(rows) {
+  const root = nodeOps.createElement('div')
+  render(
+    h({
+      render: () =>
+        h('table', rows.value.map(item => h(Row, { key: item.id, item })))
+    }),
+    root
+  )
+  resetOps()
+}
+
+const plain = shallowRef(fetchRows())
+mountList(plain)
+const keyed = listRef(fetchRows(), { key: 'id' })
+mountList(keyed)
+
+;(async () => {
+  for (const [name, rows] of [
+    ['shallowRef', plain],
+    ['listRef', keyed]
+  ]) {
+    const update = async () => {
+      rows.value = fetchRows()
+      await nextTick()
+      resetOps()
+    }
+    await benchAsync(`${name}: ${CHANGED} of ${ROWS} rows changed`, update)
+  }
+})()
@@ -0,0 +1,101 @@
+/*
+Mount / unmount churn of a list of components, e.g. paging through a table
+whose rows are components. Each row has its own scope, a render effect, a
+computed and a watcher, all created on mount and torn down on unmount.
+
+```
+node scripts/build.js runtime-test -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/mountChurn.js
+```
+*/
+
+const {
+  h,
+  ref,
+  computed,
+  watch,
+  render,
+  nodeOps,
+  resetOps,
+  nextTick
+} = require(process.env.RUNTIME_TEST || '../../packages/runtime-test')
+const { benchAsync } = require('./utils')
+
+const ROWS = +process.env.ROWS || 1000
+
+const selected = ref(-1)
+
+const Row = {
+  props: ['item'],
+  setup(props) {
+    const isSelected = computed(() => selected.value === props.item.id)
+    const label = ref(props.item.label)
+    watch(
+      () => props.item.label,
+      value => (label.value = value)
+    )
+    return () =>
+      h('tr', { class: isSelected.value ? 'selected' : '' }, [
+        h('td', props.item.id),
+        h('td', label.value)
+      ])
+  }
+}
+
+const pages = [0, 1].map(page =>
+  Array.from({ length: ROWS }, (_, i) => {
+    const id = page * ROWS + i
+    return { id, label: `row ${id}` }
+  })
+)
+
+const List = {
+  props: ['items'],
+  render() {
+    return h(
+      'table',
+      this.items.map(item => h(Row, { key: item.id, item }))
+    )
+  }
+}
+
+const root = nodeOps.createElement('div')
+let page = 0
+
+async function churn() {
+  page = page ^ 1
+  render(h(List, { items: pages[page] }), root)
+  await nextTick()
+  // the test renderer logs every node op
+  resetOps()
+}
+
+const now = () => Number(process.hrtime.bigint()) / 1e6
+
+// mount and unmount timed separately, to tell setup from teardown cost
+async function mountUnmount(cycles) {
+  let mount = 0
+  let unmount = 0
+  for (let i = 0; i < cycles; i++) {
+    let start = now()
+    render(h(List, { items: pages[0] }), root)
+    mount += now() - start
+    start = now()
+    render(null, root)
+    await nextTick()
+    unmount += now() - start
+    resetOps()
+  }
+  return { mount: mount / cycles, unmount: unmount / cycles }
+}
+
+;(async () => {
+  await mountUnmount(100)
+  const { mount, unmount } = await mountUnmount(200)
+  const report = (name, ms) =>
+    console.log(`${name.padEnd(40)} ${ms.toFixed(3).padStart(10)} ms/op`)
+  report(`mount ${ROWS} rows`, mount)
+  report(`unmount ${ROWS} rows`, unmount)
+
+  await benchAsync(`replace ${ROWS} rows (keyed)`, churn, { minTime: 3000 })
+})()
@@ -0,0 +1,41 @@
+/*
+Measures template parse time against template size. The offset-based parser
+should scale linearly: doubling the input should roughly double the time.
+
+```
+node scripts/build.js compiler-core -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/parse.js
+```
+*/
+
+const { baseParse } = require('../../packages/compiler-core')
+const { bench } = require('./utils')
+
+const row = `
+  <tr class="row" :class="{ active: item.active }" :key="item.id">
+    <td v-if="item.visible">{{ item.name }}</td>
+    <!-- price column -->
+    <td @click="select(item)" data-col="price">{{ format(item.price) }} &amp; tax</td>
+    <td><input v-model="item.qty" type="number" min="0"/></td>
+  </tr>`
+
+function createTemplate(size) {
+  let body = ''
+  while (body.length < size) {
+    body += row
+  }
+  return `<table><tbody>${body}</tbody></table>`
+}
+
+const sizes = [1, 16, 64, 256, 1024] // KB
+let prev
+for (const kb of sizes) {
+  const template = createTemplate(kb * 1024)
+  const { mean } = bench(`parse ${kb}KB`, () => baseParse(template), {
+    minTime: kb > 256 ? 2000 : 500
+  })
+  if (prev) {
+    console.log(`  x${(mean / prev).toFixed(2)} vs previous size`)
+  }
+  prev = mean
+}
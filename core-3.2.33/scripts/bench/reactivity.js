@@ -0,0 +1,75 @@
+/*
+Measures the cost of the dependency graph of @vue/reactivity on a data grid
+shaped workload: many reactive rows, each observed by its own effect (like a
+row component), and many effects depending on a single computed.
+
+```
+node scripts/build.js reactivity -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/reactivity.js
+```
+*/
+
+const {
+  reactive,
+  ref,
+  computed,
+  effect,
+  stop
+} = require(process.env.REACTIVITY || '../../packages/reactivity')
+const { bench, heapUsed } = require('./utils')
+
+const ROWS = +process.env.ROWS || 100000
+
+function createRows() {
+  const rows = []
+  for (let i = 0; i < ROWS; i++) {
+    rows.push(reactive({ id: i, label: `row ${i}`, selected: false }))
+  }
+  return rows
+}
+
+function observe(rows) {
+  const runners = []
+  for (const row of rows) {
+    runners.push(
+      effect(() => {
+        return row.selected ? row.label.toUpperCase() : row.label + row.id
+      })
+    )
+  }
+  return runners
+}
+
+// retained heap of the tracked graph
+const rows = createRows()
+const before = heapUsed()
+let runners = observe(rows)
+const after = heapUsed()
+console.log(
+  `${ROWS} rows x 3 deps: ${((after - before) / 1024 / 1024).toFixed(1)} MB ` +
+    `(${((after - before) / ROWS).toFixed(0)} B/row)`
+)
+
+bench(`track ${ROWS} effects`, () => {
+  runners.forEach(stop)
+  runners = observe(rows)
+})
+
+bench(`trigger ${ROWS} effects`, () => {
+  for (const row of rows) row.selected = !row.selected
+})
+
+bench(`re-run ${ROWS} effects (branch switch)`, () => {
+  for (const runner of runners) runner()
+})
+
+// effects reading a computed whose value rarely changes, e.g. a page count
+// derived from a list length: only a change of the value re-runs them
+const total = ref(0)
+const pages = computed(() => Math.ceil(total.value / 50))
+for (let i = 0; i < 10000; i++) {
+  effect(() => pages.value)
+}
+bench(`notify 10000 effects through a computed`, () => {
+  for (let i = 0; i < 100; i++) total.value++
+})
@@ -0,0 +1,64 @@
+/*
+Scheduler stress test: thousands of component updates queued in one tick,
+e.g. a live dashboard whose cells each watch their own feed. Updates are
+queued in reverse, random and id order, and every cell is changed twice
+so that the dedupe check is exercised as well.
+
+```
+node scripts/build.js runtime-test -f cjs -p
+NODE_ENV=production node --expose-gc scripts/bench/scheduler.js
+```
+*/
+
+const { h, ref, render, nodeOps, resetOps, nextTick } = require(process.env
+  .RUNTIME_TEST || '../../packages/runtime-test')
+const { benchAsync } = require('./utils')
+
+const CELLS = +process.env.CELLS || 5000
+
+const values = Array.from({ length: CELLS }, () => ref(0))
+
+const Cell = {
+  props: ['index'],
+  render() {
+    return h('td', values[this.index].value)
+  }
+}
+
+const Grid = {
+  render() {
+    return h(
+      'tr',
+      values.map((_, index) => h(Cell, { key: index, index }))
+    )
+  }
+}
+
+const root = nodeOps.createElement('div')
+render(h(Grid), root)
+resetOps()
+
+// cells are created in index order, so their update jobs have ascending ids
+const orders = {
+  reverse: values.map((_, i) => CELLS - 1 - i),
+  random: values.map((_, i) => i).sort(() => Math.random() - 0.5),
+  ascending: values.map((_, i) => i)
+}
+
+function update(order) {
+  return async () => {
+    for (const i of order) values[i].value++
+    for (const i of order) values[i].value++
+    await nextTick()
+    // the test renderer logs every node op
+    resetOps()
+  }
+}
+
+;(async () => {
+  for (const name in orders) {
+    await benchAsync(`update ${CELLS} cells (${name})`, update(orders[name]), {
+      minTime: 2000
+    })
+  }
+})()
@@ -0,0 +1,70 @@
+// Shared helpers for the micro-benchmarks in this directory.
+// Benchmarks run against the production CommonJS builds, so build the
+// packages under test first, e.g.:
+//
+// ```
+// node scripts/build.js compiler-core -f cjs -p
+// NODE_ENV=production node --expose-gc scripts/bench/parse.js
+// ```
+
+const chalk = require('chalk')
+
+const now = () => Number(process.hrtime.bigint()) / 1e6
+
+function gc() {
+  if (global.gc) global.gc()
+}
+
+// Runs `fn` repeatedly for at least `minTime` ms (after a short warmup) and
+// reports the mean time per iteration together with the retained heap delta
+// observed after the last run.
+exports.bench = function bench(name, fn, { minTime = 500, warmup = 3 } = {}) {
+  for (let i = 0; i < warmup; i++) fn()
+  gc()
+  const heapBefore = process.memoryUsage().heapUsed
+  let iterations = 0
+  let result
+  const start = now()
+  let elapsed = 0
+  while (elapsed < minTime) {
+    result = fn()
+    iterations++
+    elapsed = now() - start
+  }
+  const heapAfter = process.memoryUsage().heapUsed
+  const mean = elapsed / iterations
+  console.log(
+    `${chalk.bold(name.padEnd(40))} ${mean.toFixed(3).padStart(10)} ms/op` +
+      `  ${String(iterations).padStart(6)} ops` +
+      `  ${((heapAfter - heapBefore) / 1024).toFixed(0).padStart(8)} KB heap`
+  )
+  return { name, mean, iterations, result }
+}
+
+exports.benchAsync = async function benchAsync(
+  name,
+  fn,
+  { minTime = 500, warmup = 3 } = {}
+) {
+  for (let i = 0; i < warmup; i++) await fn()
+  gc()
+  let iterations = 0
+  const start = now()
+  let elapsed = 0
+  while (elapsed < minTime) {
+    await fn()
+    iterations++
+    elapsed = now() - start
+  }
+  const mean = elapsed / iterations
+  console.log(
+    `${chalk.bold(name.padEnd(40))} ${mean.toFixed(3).padStart(10)} ms/op` +
+      `  ${String(iterations).padStart(6)} ops`
+  )
+  return { name, mean, iterations }
+}
+
+exports.heapUsed = function heapUsed() {
+  gc()
+  return process.memoryUsage().heapUsed
+}